@@ -0,0 +1,66 @@
+# Writes a translation unit with a ROWS-row category spanning three enums and
+# instantiates every conversion between them, to time the compiler on a table
+# far larger than the examples.
+#
+#   cmake -DROWS=<n> -DOUTPUT=<file> -P generate_table.cmake
+#
+# lib_a is dense (0..n-1, dense_table), lib_b is spread over 32 bits
+# (perfect_hash) and lib_c is dense in reverse order.
+
+if(NOT DEFINED ROWS OR NOT DEFINED OUTPUT)
+    message(FATAL_ERROR "usage: cmake -DROWS=<n> -DOUTPUT=<file> -P generate_table.cmake")
+endif()
+
+math(EXPR last "${ROWS} - 1")
+
+set(lib_a "")
+set(lib_b "")
+set(lib_c "")
+set(rows "")
+foreach(i RANGE ${last})
+    math(EXPR sparse "(${i} * 2654435761) % 4294967291")
+    math(EXPR reversed "${last} - ${i}")
+    string(APPEND lib_a "    V${i} = ${i},\n")
+    string(APPEND lib_b "    V${i} = ${sparse}u,\n")
+    string(APPEND lib_c "    V${i} = ${reversed},\n")
+    string(APPEND rows "        { lib_a::Big::V${i}, lib_b::Big::V${i}, lib_c::Big::V${i} },\n")
+endforeach()
+
+file(WRITE "${OUTPUT}" "// Generated by generate_table.cmake - do not edit
+#include <enum_cast.hpp>
+
+namespace lib_a { enum class Big : int {
+${lib_a}}; }
+namespace lib_b { enum class Big : unsigned {
+${lib_b}}; }
+namespace lib_c { enum class Big : int {
+${lib_c}}; }
+
+struct BigTag {};
+template <> struct enum_category<lib_a::Big> { using type = BigTag; };
+template <> struct enum_category<lib_b::Big> { using type = BigTag; };
+template <> struct enum_category<lib_c::Big> { using type = BigTag; };
+
+template <>
+struct enum_mapping_traits<BigTag>
+{
+    using mapping_type = std::tuple<lib_a::Big, lib_b::Big, lib_c::Big>;
+    constexpr static mapping_type mappings[] = {
+${rows}    };
+};
+
+template <typename Dst, typename Src>
+Dst convert(Src src) { return enum_cast<Dst>(src); }
+
+template <typename Dst, typename Src>
+bool convert_checked(Src src) { return try_enum_cast<Dst>(src).has_value(); }
+
+template lib_b::Big convert<lib_b::Big>(lib_a::Big);
+template lib_c::Big convert<lib_c::Big>(lib_a::Big);
+template lib_a::Big convert<lib_a::Big>(lib_b::Big);
+template lib_c::Big convert<lib_c::Big>(lib_b::Big);
+template lib_a::Big convert<lib_a::Big>(lib_c::Big);
+template lib_b::Big convert<lib_b::Big>(lib_c::Big);
+template bool convert_checked<lib_a::Big>(lib_b::Big);
+template bool convert_checked<lib_c::Big>(lib_b::Big);
+")
@@ -0,0 +1,475 @@
+/*
+ * enum_cast_benchmark.cpp - Microbenchmarks for the enum_cast lookup strategies
+ *
+ * Categories:
+ * - Dense:  256 rows, consecutive source values (dense_table)
+ * - Sparse: 256 rows spread over 32 bits (perfect_hash), also with sorted_array
+ *           and linear_scan forced on the same values
+ * - Huge:   16384 rows spread over 32 bits, larger than L1 (sorted_array)
+ * - Flags:  64-bit flag enums with 48 mapped bits in shuffled order
+ * - Named:  256 rows with names of 5 to 20 characters (name perfect hash)
+ *
+ * The Dense and Sparse rows are also published through enum_cast_registry, to
+ * compare the run-time tables against the compile-time ones.
+ *
+ * When TBB is found, the par_unseq batch overloads run over columns much larger
+ * than the caches with 1 to 16 workers, showing the scaling up to the memory
+ * bandwidth.
+ *
+ * Run with --benchmark_format=json or --benchmark_out=<file> --benchmark_out_format=json
+ * to record results.
+ */
+
+#include <enum_cast.hpp>
+#include <enum_cast_registry.hpp>
+
+#include <benchmark/benchmark.h>
+
+#if defined(ENUM_CAST_BENCHMARK_TBB)
+#include <enum_cast_execution.hpp>
+
+#include <tbb/global_control.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lib_x {
+    enum class Dense : int {};
+    enum class Sparse : int {};
+    enum class SparseSorted : int {};
+    enum class SparseScan : int {};
+    enum class Huge : int {};
+    enum class Flags : std::uint64_t {};
+    enum class Named : int {};
+}
+
+namespace lib_y {
+    enum class Dense : int {};
+    enum class Sparse : int {};
+    enum class SparseSorted : int {};
+    enum class SparseScan : int {};
+    enum class Huge : int {};
+    enum class Flags : std::uint64_t {};
+    enum class Named : int {};
+}
+
+constexpr int dense_value(std::uint32_t i)
+{
+    return static_cast<int>(i);
+}
+
+constexpr int sparse_value(std::uint32_t i)
+{
+    return static_cast<int>(i * 2654435761u);
+}
+
+// Rows map SrcValue(i) to Rows - 1 - i
+template <typename Src, typename Dst, std::size_t Rows, int (*SrcValue)(std::uint32_t),
+          enum_lookup_strategy Strategy = enum_lookup_strategy::automatic>
+struct generated_mapping_traits
+{
+    using mapping_type = std::tuple<Src, Dst>;
+    constexpr static enum_lookup_strategy lookup_strategy = Strategy;
+    constexpr static auto mappings = [] {
+        std::array<mapping_type, Rows> result {};
+        for (std::uint32_t i = 0; i < Rows; ++i) {
+            result[i] = { static_cast<Src>(SrcValue(i)), static_cast<Dst>(Rows - 1 - i) };
+        }
+        return result;
+    }();
+};
+
+struct DenseTag {};
+struct SparseTag {};
+struct SparseSortedTag {};
+struct SparseScanTag {};
+struct HugeTag {};
+struct FlagsTag {};
+struct NamedTag {};
+
+template <> struct enum_category<lib_x::Dense> { using type = DenseTag; };
+template <> struct enum_category<lib_y::Dense> { using type = DenseTag; };
+template <> struct enum_category<lib_x::Sparse> { using type = SparseTag; };
+template <> struct enum_category<lib_y::Sparse> { using type = SparseTag; };
+template <> struct enum_category<lib_x::SparseSorted> { using type = SparseSortedTag; };
+template <> struct enum_category<lib_y::SparseSorted> { using type = SparseSortedTag; };
+template <> struct enum_category<lib_x::SparseScan> { using type = SparseScanTag; };
+template <> struct enum_category<lib_y::SparseScan> { using type = SparseScanTag; };
+template <> struct enum_category<lib_x::Huge> { using type = HugeTag; };
+template <> struct enum_category<lib_y::Huge> { using type = HugeTag; };
+template <> struct enum_category<lib_x::Flags> { using type = FlagsTag; };
+template <> struct enum_category<lib_y::Flags> { using type = FlagsTag; };
+template <> struct enum_category<lib_x::Named> { using type = NamedTag; };
+template <> struct enum_category<lib_y::Named> { using type = NamedTag; };
+
+template <>
+struct enum_mapping_traits<DenseTag> : generated_mapping_traits<lib_x::Dense, lib_y::Dense, 256, dense_value> {};
+
+template <>
+struct enum_mapping_traits<SparseTag> : generated_mapping_traits<lib_x::Sparse, lib_y::Sparse, 256, sparse_value> {};
+
+template <>
+struct enum_mapping_traits<SparseSortedTag>
+    : generated_mapping_traits<lib_x::SparseSorted, lib_y::SparseSorted, 256, sparse_value, enum_lookup_strategy::sorted_array> {};
+
+template <>
+struct enum_mapping_traits<SparseScanTag>
+    : generated_mapping_traits<lib_x::SparseScan, lib_y::SparseScan, 256, sparse_value, enum_lookup_strategy::linear_scan> {};
+
+template <>
+struct enum_mapping_traits<HugeTag> : generated_mapping_traits<lib_x::Huge, lib_y::Huge, 16384, sparse_value> {};
+
+template <>
+struct enum_mapping_traits<FlagsTag>
+{
+    using mapping_type = std::tuple<lib_x::Flags, lib_y::Flags>;
+    constexpr static auto mappings = [] {
+        std::array<mapping_type, 48> result {};
+        for (std::uint32_t bit = 0; bit < 48; ++bit) {
+            result[bit] = { static_cast<lib_x::Flags>(std::uint64_t(1) << bit),
+                            static_cast<lib_y::Flags>(std::uint64_t(1) << ((bit * 37 + 5) % 64)) };
+        }
+        return result;
+    }();
+};
+
+// "STATUS_" style names of varying length, in static storage for the name column
+struct generated_names
+{
+    constexpr static std::size_t count = 256;
+    char text[count][24] {};
+
+    constexpr generated_names()
+    {
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t length = 0;
+            for (std::size_t j = 0; j < 4 + i % 16; ++j) {
+                text[i][length++] = static_cast<char>('A' + (i * 7 + j * 13) % 26);
+            }
+            text[i][length++] = '_';
+            for (std::size_t value = i; length == 5 + i % 16 || value != 0; value /= 10) {
+                text[i][length++] = static_cast<char>('0' + value % 10);
+            }
+        }
+    }
+};
+
+constexpr generated_names names {};
+
+template <>
+struct enum_mapping_traits<NamedTag>
+{
+    using mapping_type = std::tuple<lib_x::Named, lib_y::Named, std::string_view>;
+    constexpr static auto mappings = [] {
+        std::array<mapping_type, generated_names::count> result {};
+        for (std::uint32_t i = 0; i < generated_names::count; ++i) {
+            result[i] = { static_cast<lib_x::Named>(sparse_value(i)), static_cast<lib_y::Named>(i), names.text[i] };
+        }
+        return result;
+    }();
+};
+
+namespace {
+
+constexpr std::size_t input_size = 1 << 16;
+
+enum class input_order { sequential, random };
+
+// Source values drawn from the mapped ones, with roughly one in eight unmapped
+template <typename Src>
+std::vector<Src> make_inputs(input_order order, std::size_t count = input_size)
+{
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    const auto& mappings = MappingTraits::mappings;
+    std::vector<Src> inputs(count);
+    std::mt19937 random(42);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t row = order == input_order::sequential ? i % std::size(mappings) : random() % std::size(mappings);
+        inputs[i] = random() % 8 == 0 ? static_cast<Src>(random()) : std::get<Src>(mappings[row]);
+    }
+    return inputs;
+}
+
+template <typename Dst, typename Src>
+void scalar_hot(benchmark::State& state)
+{
+    auto inputs = make_inputs<Src>(static_cast<input_order>(state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_cast<Dst>(inputs[i]));
+        i = (i + 1) & (input_size - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/*
+ * Evicts the caches before each timed batch, so every lookup starts from memory.
+ * The batch is short enough that its own loads stay mostly cold.
+ */
+template <typename Dst, typename Src>
+void scalar_cold(benchmark::State& state)
+{
+    constexpr std::size_t batch = 64;
+    auto inputs = make_inputs<Src>(input_order::random, batch);
+    std::vector<std::uint64_t> evict(8 << 20);
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (auto& word : evict) {
+            word += 1;
+        }
+        benchmark::ClobberMemory();
+        state.ResumeTiming();
+        for (Src src : inputs) {
+            benchmark::DoNotOptimize(enum_cast<Dst>(src));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+
+template <typename Dst, typename Src>
+void batch(benchmark::State& state)
+{
+    auto inputs = make_inputs<Src>(input_order::random, static_cast<std::size_t>(state.range(0)));
+    std::vector<Dst> outputs(inputs.size());
+    for (auto _ : state) {
+        enum_cast_n<Dst>(std::span<const Src>(inputs), std::span<Dst>(outputs));
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+    state.SetBytesProcessed(state.iterations() * inputs.size() * (sizeof(Src) + sizeof(Dst)));
+}
+
+// Baseline for batch: the same work as a plain loop over the scalar cast
+template <typename Dst, typename Src>
+void batch_scalar_loop(benchmark::State& state)
+{
+    auto inputs = make_inputs<Src>(input_order::random, static_cast<std::size_t>(state.range(0)));
+    std::vector<Dst> outputs(inputs.size());
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            outputs[i] = enum_cast<Dst>(inputs[i]);
+        }
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+// Flag inputs with exactly state.range(0) bits set, drawn from the 64 source bits
+std::vector<lib_x::Flags> make_flag_inputs(int popcount, std::size_t count)
+{
+    std::vector<lib_x::Flags> inputs(count);
+    std::mt19937_64 random(42);
+    std::array<int, 64> bits {};
+    std::iota(bits.begin(), bits.end(), 0);
+    for (auto& input : inputs) {
+        std::shuffle(bits.begin(), bits.end(), random);
+        std::uint64_t value = 0;
+        for (int i = 0; i < popcount; ++i) {
+            value |= std::uint64_t(1) << bits[i];
+        }
+        input = static_cast<lib_x::Flags>(value);
+    }
+    return inputs;
+}
+
+void flags_scalar(benchmark::State& state)
+{
+    auto inputs = make_flag_inputs(static_cast<int>(state.range(0)), input_size);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_flag_bits_cast<lib_y::Flags>(inputs[i]));
+        i = (i + 1) & (input_size - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void flags_batch(benchmark::State& state)
+{
+    auto inputs = make_flag_inputs(static_cast<int>(state.range(0)), input_size);
+    std::vector<lib_y::Flags> outputs(inputs.size());
+    for (auto _ : state) {
+        enum_flag_bits_cast_n<lib_y::Flags>(std::span<const lib_x::Flags>(inputs), std::span<lib_y::Flags>(outputs));
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+    state.SetBytesProcessed(state.iterations() * inputs.size() * 2 * sizeof(std::uint64_t));
+}
+
+#if defined(ENUM_CAST_BENCHMARK_TBB)
+// Column of state.range(0) elements converted under par_unseq by at most state.range(1) workers
+template <typename Dst, typename Src>
+void batch_parallel(benchmark::State& state)
+{
+    tbb::global_control workers(tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(state.range(1)));
+    auto inputs = make_inputs<Src>(input_order::random, static_cast<std::size_t>(state.range(0)));
+    std::vector<Dst> outputs(inputs.size());
+    for (auto _ : state) {
+        enum_cast_n<Dst>(std::execution::par_unseq, std::span<const Src>(inputs), std::span<Dst>(outputs));
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+    state.SetBytesProcessed(state.iterations() * inputs.size() * (sizeof(Src) + sizeof(Dst)));
+}
+
+void flags_batch_parallel(benchmark::State& state)
+{
+    tbb::global_control workers(tbb::global_control::max_allowed_parallelism, static_cast<std::size_t>(state.range(1)));
+    auto inputs = make_flag_inputs(24, static_cast<std::size_t>(state.range(0)));
+    std::vector<lib_y::Flags> outputs(inputs.size());
+    for (auto _ : state) {
+        enum_flag_bits_cast_n<lib_y::Flags>(std::execution::par_unseq, std::span<const lib_x::Flags>(inputs),
+                                            std::span<lib_y::Flags>(outputs));
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+    state.SetBytesProcessed(state.iterations() * inputs.size() * 2 * sizeof(std::uint64_t));
+}
+#endif
+
+// Names drawn from the mapped ones, copied out of static storage, with roughly one in eight unmapped
+std::vector<std::string> make_name_inputs()
+{
+    std::vector<std::string> inputs(input_size);
+    std::mt19937 random(42);
+    for (auto& input : inputs) {
+        input = names.text[random() % generated_names::count];
+        if (random() % 8 == 0) {
+            input.back() = '#';
+        }
+    }
+    return inputs;
+}
+
+void from_string(benchmark::State& state)
+{
+    auto inputs = make_name_inputs();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_from_string<lib_y::Named>(inputs[i]));
+        i = (i + 1) & (input_size - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void from_string_n(benchmark::State& state)
+{
+    auto inputs = make_name_inputs();
+    std::vector<std::string_view> views(inputs.begin(), inputs.end());
+    std::vector<lib_y::Named> outputs(views.size());
+    std::vector<std::uint64_t> errors((views.size() + 63) / 64);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_from_string_n<lib_y::Named>(views, outputs, errors));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * views.size());
+}
+
+// One comma-separated column, reported in bytes of text parsed
+void from_string_split(benchmark::State& state)
+{
+    std::string buffer;
+    for (const auto& input : make_name_inputs()) {
+        buffer += input;
+        buffer += ',';
+    }
+    std::vector<lib_y::Named> outputs(input_size);
+    std::vector<std::uint64_t> errors(input_size / 64);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_from_string_split<lib_y::Named>(buffer, ',', std::span<lib_y::Named>(outputs), errors));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * input_size);
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+
+void to_string(benchmark::State& state)
+{
+    auto inputs = make_inputs<lib_x::Named>(input_order::random);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(enum_to_string(inputs[i]));
+        i = (i + 1) & (input_size - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// The same rows as the category, published at run time
+template <typename Dst, typename Src>
+void registered_hot(benchmark::State& state)
+{
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    using registry = enum_cast_registry<MappingTraits, Src, Dst>;
+    std::vector<typename registry::row_type> rows;
+    for (const auto& mapping : MappingTraits::mappings) {
+        rows.emplace_back(std::get<Src>(mapping), std::get<Dst>(mapping));
+    }
+    registry::publish(rows);
+    auto inputs = make_inputs<Src>(static_cast<input_order>(state.range(0)));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(registered_enum_cast<MappingTraits, Dst>(inputs[i]));
+        i = (i + 1) & (input_size - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void order_arguments(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->ArgName("random")->Arg(static_cast<int>(input_order::sequential))->Arg(static_cast<int>(input_order::random));
+}
+
+} // namespace
+
+BENCHMARK(scalar_hot<lib_y::Dense, lib_x::Dense>)->Name("enum_cast/dense/hot")->Apply(order_arguments);
+BENCHMARK(scalar_hot<lib_y::Sparse, lib_x::Sparse>)->Name("enum_cast/sparse_hash/hot")->Apply(order_arguments);
+BENCHMARK(scalar_hot<lib_y::SparseSorted, lib_x::SparseSorted>)->Name("enum_cast/sparse_sorted/hot")->Apply(order_arguments);
+BENCHMARK(scalar_hot<lib_y::SparseScan, lib_x::SparseScan>)->Name("enum_cast/sparse_scan/hot")->Apply(order_arguments);
+BENCHMARK(scalar_hot<lib_y::Huge, lib_x::Huge>)->Name("enum_cast/huge_sorted/hot")->Apply(order_arguments);
+
+BENCHMARK(registered_hot<lib_y::Dense, lib_x::Dense>)->Name("registered_enum_cast/dense/hot")->Apply(order_arguments);
+BENCHMARK(registered_hot<lib_y::Sparse, lib_x::Sparse>)->Name("registered_enum_cast/sparse_hash/hot")->Apply(order_arguments);
+
+BENCHMARK(scalar_cold<lib_y::Dense, lib_x::Dense>)->Name("enum_cast/dense/cold");
+BENCHMARK(scalar_cold<lib_y::Sparse, lib_x::Sparse>)->Name("enum_cast/sparse_hash/cold");
+BENCHMARK(scalar_cold<lib_y::SparseSorted, lib_x::SparseSorted>)->Name("enum_cast/sparse_sorted/cold");
+BENCHMARK(scalar_cold<lib_y::Huge, lib_x::Huge>)->Name("enum_cast/huge_sorted/cold");
+
+BENCHMARK(batch<lib_y::Dense, lib_x::Dense>)->Name("enum_cast_n/dense")->Range(1 << 10, 1 << 20);
+BENCHMARK(batch_scalar_loop<lib_y::Dense, lib_x::Dense>)->Name("enum_cast_loop/dense")->Range(1 << 10, 1 << 20);
+BENCHMARK(batch<lib_y::Sparse, lib_x::Sparse>)->Name("enum_cast_n/sparse_hash")->Range(1 << 10, 1 << 20);
+BENCHMARK(batch<lib_y::Huge, lib_x::Huge>)->Name("enum_cast_n/huge_sorted")->Range(1 << 10, 1 << 20);
+
+BENCHMARK(flags_scalar)->Name("enum_flag_bits_cast/popcount")->DenseRange(0, 48, 8);
+BENCHMARK(flags_batch)->Name("enum_flag_bits_cast_n/popcount")->DenseRange(0, 48, 8);
+
+#if defined(ENUM_CAST_BENCHMARK_TBB)
+BENCHMARK(batch_parallel<lib_y::Dense, lib_x::Dense>)
+    ->Name("enum_cast_n/dense/par_unseq")
+    ->ArgNames({ "elements", "workers" })
+    ->ArgsProduct({ { 1 << 25 }, { 1, 2, 4, 8, 16 } })
+    ->UseRealTime();
+BENCHMARK(flags_batch_parallel)
+    ->Name("enum_flag_bits_cast_n/par_unseq")
+    ->ArgNames({ "elements", "workers" })
+    ->ArgsProduct({ { 1 << 24 }, { 1, 2, 4, 8, 16 } })
+    ->UseRealTime();
+#endif
+
+BENCHMARK(from_string)->Name("enum_from_string/hash");
+BENCHMARK(from_string_n)->Name("enum_from_string_n/hash");
+BENCHMARK(from_string_split)->Name("enum_from_string_split/hash");
+BENCHMARK(to_string)->Name("enum_to_string/hash");
+
+BENCHMARK_MAIN();
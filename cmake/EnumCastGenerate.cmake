@@ -0,0 +1,79 @@
+# enum_cast_generate(<target> <header>
+#                    INPUTS <file>...
+#                    [CATEGORY <tag>]
+#                    [JOIN <enum>...]
+#                    [SORT_BY <enum>]
+#                    [INCLUDES <header>...]
+#                    [MODULE_PARTITION <name>])
+#
+# Runs tools/enum_cast_gen.py over the .json, .csv and .proto INPUTS and writes
+# <header> (relative to the current binary directory) with the mapping traits
+# laid out ahead of time. The header is regenerated when an input changes, and
+# its directory is added to the include path of <target>.
+#
+# With MODULE_PARTITION, <header> is instead the module partition
+# enum_cast:<name>, added to the module of <target>; see enum_cast_add_module().
+
+# Installed packages keep the script next to this file, the source tree in tools/
+if(EXISTS "${CMAKE_CURRENT_LIST_DIR}/enum_cast_gen.py")
+    set_property(GLOBAL PROPERTY enum_cast_gen_script "${CMAKE_CURRENT_LIST_DIR}/enum_cast_gen.py")
+else()
+    get_filename_component(script "${CMAKE_CURRENT_LIST_DIR}/../tools/enum_cast_gen.py" ABSOLUTE)
+    set_property(GLOBAL PROPERTY enum_cast_gen_script "${script}")
+    unset(script)
+endif()
+
+function(enum_cast_generate target header)
+    cmake_parse_arguments(PARSE_ARGV 2 arg "" "CATEGORY;SORT_BY;MODULE_PARTITION" "INPUTS;JOIN;INCLUDES")
+    if(NOT arg_INPUTS)
+        message(FATAL_ERROR "enum_cast_generate: INPUTS is required")
+    endif()
+    find_package(Python3 COMPONENTS Interpreter REQUIRED)
+    get_property(script GLOBAL PROPERTY enum_cast_gen_script)
+
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/${header}")
+    set(inputs "")
+    foreach(input IN LISTS arg_INPUTS)
+        get_filename_component(input "${input}" ABSOLUTE BASE_DIR "${CMAKE_CURRENT_SOURCE_DIR}")
+        list(APPEND inputs "${input}")
+    endforeach()
+
+    set(options "")
+    if(arg_CATEGORY)
+        list(APPEND options --category "${arg_CATEGORY}")
+    endif()
+    if(arg_JOIN)
+        list(APPEND options --join ${arg_JOIN})
+    endif()
+    if(arg_SORT_BY)
+        list(APPEND options --sort-by "${arg_SORT_BY}")
+    endif()
+    foreach(include IN LISTS arg_INCLUDES)
+        list(APPEND options --include "${include}")
+    endforeach()
+    if(arg_MODULE_PARTITION)
+        if(CMAKE_VERSION VERSION_LESS 3.28)
+            message(FATAL_ERROR "enum_cast_generate: MODULE_PARTITION requires CMake 3.28 or newer")
+        endif()
+        list(APPEND options --module-partition "${arg_MODULE_PARTITION}")
+    endif()
+
+    # Inputs go before the options so that a trailing --join list cannot swallow them
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND Python3::Interpreter "${script}" ${inputs} -o "${output}" ${options}
+        DEPENDS ${inputs} "${script}"
+        COMMENT "Generating enum_cast mappings ${header}"
+        VERBATIM)
+    get_filename_component(output_dir "${output}" DIRECTORY)
+    if(arg_MODULE_PARTITION)
+        target_sources(${target} PUBLIC
+            FILE_SET enum_cast_partitions TYPE CXX_MODULES
+            BASE_DIRS "${output_dir}"
+            FILES "${output}")
+        set_property(TARGET ${target} APPEND PROPERTY ENUM_CAST_MODULE_PARTITIONS "${arg_MODULE_PARTITION}")
+    else()
+        target_sources(${target} PRIVATE "${output}")
+        target_include_directories(${target} PRIVATE "${output_dir}")
+    endif()
+endfunction()
@@ -0,0 +1,41 @@
+# enum_cast_add_module(<target>)
+#
+# Adds the C++20 named module enum_cast to <target>: the :core partition built
+# from modules/enum_cast_core.cppm, and a primary interface unit that
+# re-exports it together with every partition enum_cast_generate() wrote for
+# <target> with MODULE_PARTITION. Consumers of <target> then `import enum_cast;`
+# and enum_cast.hpp is parsed once per build instead of once per translation
+# unit. Requires CMake 3.28 and a compiler and generator with C++20 module
+# support.
+
+# Installed packages keep the partition next to this file, the source tree in modules/
+if(EXISTS "${CMAKE_CURRENT_LIST_DIR}/enum_cast_core.cppm")
+    set_property(GLOBAL PROPERTY enum_cast_module_core "${CMAKE_CURRENT_LIST_DIR}/enum_cast_core.cppm")
+else()
+    get_filename_component(core "${CMAKE_CURRENT_LIST_DIR}/../modules/enum_cast_core.cppm" ABSOLUTE)
+    set_property(GLOBAL PROPERTY enum_cast_module_core "${core}")
+    unset(core)
+endif()
+
+function(enum_cast_add_module target)
+    if(CMAKE_VERSION VERSION_LESS 3.28)
+        message(FATAL_ERROR "enum_cast_add_module: C++20 modules require CMake 3.28 or newer")
+    endif()
+    get_property(core GLOBAL PROPERTY enum_cast_module_core)
+    get_filename_component(core_dir "${core}" DIRECTORY)
+
+    # Written at generate time, so partitions added after this call are re-exported too
+    set(partitions "$<TARGET_PROPERTY:${target},ENUM_CAST_MODULE_PARTITIONS>")
+    set(primary "${CMAKE_CURRENT_BINARY_DIR}/enum_cast_module/${target}/enum_cast.cppm")
+    file(GENERATE OUTPUT "${primary}" CONTENT
+        "// Generated by enum_cast_add_module for ${target} - do not edit\nexport module enum_cast;\n\nexport import :core;\n$<$<BOOL:${partitions}>:export import :$<JOIN:${partitions},;\nexport import :>;\n>")
+
+    target_sources(${target} PUBLIC
+        FILE_SET enum_cast_module TYPE CXX_MODULES
+        BASE_DIRS "${core_dir}" "${CMAKE_CURRENT_BINARY_DIR}/enum_cast_module/${target}"
+        FILES "${core}" "${primary}")
+    # Scans the target's own sources too, which the policies of projects requiring CMake < 3.28 leave unscanned
+    set_property(TARGET ${target} PROPERTY CXX_SCAN_FOR_MODULES ON)
+    target_link_libraries(${target} PUBLIC enum_cast::enum_cast)
+    target_compile_features(${target} PUBLIC cxx_std_20)
+endfunction()
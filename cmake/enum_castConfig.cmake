@@ -0,0 +1,3 @@
+include("${CMAKE_CURRENT_LIST_DIR}/enum_castTargets.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/EnumCastGenerate.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/EnumCastModule.cmake")
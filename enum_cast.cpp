@@ -1,85 +1,22 @@
 /*
- * enum_cast.h - Utility for safely casting between different enum types
+ * enum_cast.cpp - Example usage of enum_cast
  *
- * This header provides a type-safe mechanism for converting between enum values
- * from different libraries that represent the same logical concepts.
- * 
- * Key components:
- * - EnumConcept: Ensures template parameters are enum types
- * - MappingTraitsConcept: Validates mapping trait structures
- * - enum_category: Associates enums with their conceptual category
- * - enum_mapping_traits: Defines mappings between enum values
- * - enum_cast: Performs the actual enum conversion
- */
-
-#include <ranges>
-#include <type_traits>
-
-
-template <typename T>
-concept EnumConcept = std::is_enum_v<T>;
-
-template <typename T>
-concept EnumMappingTraitsConcept = requires {
-    typename T::mapping_type;
-    { T::mappings } -> std::ranges::range;
-    { *std::begin(T::mappings) } -> std::convertible_to<typename T::mapping_type>;
-};
-
-// Trait detection - determines which category an enum belongs to
-template <EnumConcept Enum>
-struct enum_category;
-
-template <EnumConcept Enum>
-using enum_category_t = typename enum_category<Enum>::type;
-
-// Enum mapping traits declaration - implemented per enum category
-template <typename Tag>
-struct enum_mapping_traits;
-
-/**
- * Converts an enum value from one type to another within the same category
- * 
- * @tparam Dst The destination enum type
- * @tparam Src The source enum type
- * @param src The source enum value to convert
- * @return The equivalent enum value in the destination type
- * 
- * @note Source and destination enums must belong to the same category
- * @note Returns the first enum value (0) if no mapping is found
- */
-template <EnumConcept Dst, EnumConcept Src>
-constexpr Dst enum_cast(Src src)
-{
-    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
-                 "Source and destination enums must be of the same category");
-    using Category = enum_category_t<Src>;
-    using MappingTraits = enum_mapping_traits<Category>;
-    for (const auto& mapping : MappingTraits::mappings) {
-        if (std::get<Src>(mapping) == src) {
-            return std::get<Dst>(mapping);
-        }
-    }
-    return static_cast<Dst>(0);
-}
-
-/*
- * Example usage - This section would be in your main application code
  * The following examples show how to use the enum_cast utility with
  * different enum types from multiple libraries.
  */
 
+#include <enum_cast.hpp>
+
 /*
  * Recommended Directory Structure:
- *   - utilities/
- *   -- enum_cast.h          // enum_cast function and related support classes
+ *   - include/
+ *   -- enum_cast.hpp        // enum_cast, enum_flag_bits_cast and related support classes
  *   - Color/
  *   -- ColorDefs.h          // Color enum mappings
  *   - Shape/
  *   -- ShapeDefs.h          // Shape enum mappings
- *   - concepts/
- *   -- enum_concept.h       // EnumConcept definition
- *   -- enum_mapping_traits_concept.h     // MappingTraitsConcept definition
+ *   - Palette/
+ *   -- PaletteDefs.h        // Palette enum mappings, sharing lib_b::Color with Color
  */
 
 namespace lib_a {
@@ -97,8 +34,6 @@ namespace lib_c {
     enum class Shape { Circle = 2, Square = 3, Triangle = 4 };
 }
 
-#include <tuple>
-
 /*
  * ColorDefs.h - Contains enum category and mapping definitions for colors
  * 
@@ -132,17 +67,105 @@ template <> struct enum_category<lib_a::Shape> { using type = EnumShapeTag; };
 template <> struct enum_category<lib_b::Shape> { using type = EnumShapeTag; };
 template <> struct enum_category<lib_c::Shape> { using type = EnumShapeTag; };
 
+// The shape enumerators share their names across libraries, so the rows can be
+// derived from the names instead of being listed
 template <>
 struct enum_mapping_traits<EnumShapeTag>
 {
     using mapping_type = std::tuple<lib_a::Shape, lib_b::Shape, lib_c::Shape>;
+    constexpr static auto mappings = enum_mappings_by_name<mapping_type>();
+};
+
+/*
+ * Sparse codes including 0, looked up through a minimal perfect hash; zero and
+ * other small keys must hash as freely as the rest for the hash to be built
+ */
+namespace lib_a {
+    enum class Error : std::int32_t { None = 0, Io = 102947, Timeout = 205894, Denied = 308841, Busy = 411788,
+                                      Closed = 514735, Reset = 617682, Refused = 720629, Aborted = 823576 };
+}
+
+namespace lib_b {
+    enum class Error { None, Io, Timeout, Denied, Busy, Closed, Reset, Refused, Aborted };
+}
+
+struct EnumErrorTag {};
+template <> struct enum_category<lib_a::Error> { using type = EnumErrorTag; };
+template <> struct enum_category<lib_b::Error> { using type = EnumErrorTag; };
+
+template <>
+struct enum_mapping_traits<EnumErrorTag>
+{
+    using mapping_type = std::tuple<lib_a::Error, lib_b::Error>;
+    constexpr static mapping_type mappings[] = {
+        { lib_a::Error::None, lib_b::Error::None },       { lib_a::Error::Io, lib_b::Error::Io },
+        { lib_a::Error::Timeout, lib_b::Error::Timeout }, { lib_a::Error::Denied, lib_b::Error::Denied },
+        { lib_a::Error::Busy, lib_b::Error::Busy },       { lib_a::Error::Closed, lib_b::Error::Closed },
+        { lib_a::Error::Reset, lib_b::Error::Reset },     { lib_a::Error::Refused, lib_b::Error::Refused },
+        { lib_a::Error::Aborted, lib_b::Error::Aborted },
+    };
+};
+
+static_assert(enum_cast_detail::select_lookup_strategy<enum_mapping_traits<EnumErrorTag>, lib_a::Error>() ==
+              enum_lookup_strategy::perfect_hash);
+static_assert(enum_cast<lib_b::Error>(lib_a::Error::None) == lib_b::Error::None);
+static_assert(enum_cast<lib_b::Error>(lib_a::Error::Aborted) == lib_b::Error::Aborted);
+static_assert(!try_enum_cast<lib_b::Error>(static_cast<lib_a::Error>(1)));
+
+// Every pair of color libraries is one-to-one, so all six directions share one row index per library
+static_assert(enum_round_trips_v<lib_a::Color, lib_c::Color>);
+static_assert(enum_cast<lib_a::Color>(enum_cast<lib_c::Color>(lib_a::Color::Blue)) == lib_a::Color::Blue);
+
+/*
+ * PaletteDefs.h - A second category sharing lib_b::Color with the color category
+ *
+ * lib_d names only some of lib_b's colors, so conversions through lib_b can
+ * lose values on either hop.
+ */
+namespace lib_d {
+    enum class Color { Crimson = 10, Lime = 20, Amber = 30 };
+}
+
+struct EnumPaletteTag {};
+template <> struct enum_category<lib_d::Color> { using type = EnumPaletteTag; };
+
+template <>
+struct enum_mapping_traits<EnumPaletteTag>
+{
+    using mapping_type = std::tuple<lib_b::Color, lib_d::Color>;
     constexpr static mapping_type mappings[] = {
-        { lib_a::Shape::Circle, lib_b::Shape::Circle, lib_c::Shape::Circle },
-        { lib_a::Shape::Square, lib_b::Shape::Square, lib_c::Shape::Square },
-        { lib_a::Shape::Triangle, lib_b::Shape::Triangle, lib_c::Shape::Triangle }
+        { lib_b::Color::Red, lib_d::Color::Crimson },
+        { lib_b::Color::Green, lib_d::Color::Lime },
+        { lib_b::Color::Yellow, lib_d::Color::Amber }
     };
 };
 
+static_assert(enum_cast_via<lib_b::Color, lib_d::Color>(lib_a::Color::Green) == lib_d::Color::Lime);
+static_assert(enum_cast_via<lib_b::Color, lib_a::Color>(lib_d::Color::Crimson) == lib_a::Color::Red);
+static_assert(try_enum_cast_via<lib_b::Color, lib_d::Color>(lib_c::Color::Red) == lib_d::Color::Crimson);
+static_assert(try_enum_cast_via<lib_b::Color, lib_a::Color>(lib_d::Color::Lime) == lib_a::Color::Green);
+// Blue has no palette row and Yellow has no lib_a color: the strict forms reject them, and the
+// lenient forms fall back to the destination's zero value, as the second hop alone would
+static_assert(!try_enum_cast_via<lib_b::Color, lib_d::Color>(lib_a::Color::Blue));
+static_assert(!try_enum_cast_via<lib_b::Color, lib_a::Color>(lib_d::Color::Amber));
+static_assert(enum_cast_via<lib_b::Color, lib_d::Color>(lib_a::Color::Blue) == static_cast<lib_d::Color>(0));
+static_assert(enum_cast_via<lib_b::Color, lib_a::Color>(lib_d::Color::Amber) == static_cast<lib_a::Color>(0));
+
+// Whole ranges convert lazily element by element, and spans convert in bulk
+static_assert([] {
+    lib_c::Color records[] = { lib_c::Color::Blue, lib_c::Color::Red, lib_c::Color::Green };
+    constexpr lib_a::Color expected[] = { lib_a::Color::Blue, lib_a::Color::Red, lib_a::Color::Green };
+    lib_a::Color converted[3] {};
+    enum_cast_n<lib_a::Color>(std::span<lib_c::Color>(records), std::span<lib_a::Color>(converted));
+    return std::ranges::equal(records | views::enum_cast<lib_a::Color>, expected) &&
+           std::ranges::equal(converted, expected);
+}());
+
+#if defined(__cpp_lib_expected)
+static_assert(expected_enum_cast<lib_b::Error>(lib_a::Error::Timeout) == lib_b::Error::Timeout);
+static_assert(!expected_enum_cast<lib_b::Error>(static_cast<lib_a::Error>(1)).has_value());
+#endif
+
 #include <iostream>
 
 int main()
@@ -156,5 +179,9 @@ int main()
     lib_a::Shape a_shape = enum_cast<lib_a::Shape>(lib_b::Shape::Circle);
     std::cout << static_cast<int>(a_shape) << std::endl;
 
+    // One lookup for the whole row instead of one per destination library
+    auto [a_green, b_green, c_green] = enum_cast_all(lib_b::Color::Green);
+    std::cout << static_cast<int>(a_green) << ' ' << static_cast<int>(b_green) << ' ' << static_cast<int>(c_green) << std::endl;
+
     return 0;
 }
\ No newline at end of file
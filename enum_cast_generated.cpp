@@ -0,0 +1,31 @@
+/*
+ * enum_cast_generated.cpp - Example usage of generated mapping tables
+ *
+ * vendor_status.hpp is written at build time by tools/enum_cast_gen.py from
+ * enum_cast_generated.json, through the enum_cast_generate() CMake function:
+ *
+ *   enum_cast_generate(my_target vendor_status.hpp INPUTS enum_cast_generated.json)
+ */
+
+#include "vendor_status.hpp"
+
+#include <iostream>
+
+// Both Mode rows hold Locked; the generator keeps their order, so the first row still wins
+static_assert(enum_cast<vendor_a::Mode>(vendor_b::Mode::Locked) == vendor_a::Mode::Exclusive);
+static_assert(enum_cast<vendor_b::Mode>(vendor_a::Mode::Shared) == vendor_b::Mode::Locked);
+
+int main()
+{
+    vendor_b::Status b_status = enum_cast<vendor_b::Status>(vendor_a::Status::Busy);
+    std::cout << static_cast<int>(b_status) << std::endl;
+
+    vendor_a::Status a_status = enum_cast<vendor_a::Status>(vendor_b::Status::Down);
+    std::cout << static_cast<int>(a_status) << std::endl;
+
+    // Unmapped values fall back to the descriptor's default row
+    a_status = enum_cast<vendor_a::Status>(vendor_b::Status::Invalid);
+    std::cout << static_cast<int>(a_status) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+/*
+ * enum_cast_module.cpp - Example usage of the enum_cast C++20 module
+ *
+ * The mappings of enum_cast_generated.json are written as the module partition
+ * enum_cast:vendor_status, and enum_cast_add_module() adds the module with that
+ * partition to the target:
+ *
+ *   enum_cast_generate(my_target vendor_status.cppm INPUTS enum_cast_generated.json
+ *                      MODULE_PARTITION vendor_status)
+ *   enum_cast_add_module(my_target)
+ */
+
+#include <iostream>
+
+import enum_cast;
+
+static_assert(enum_round_trips_v<vendor_a::Status, vendor_b::Status>);
+
+int main()
+{
+    vendor_b::Status b_status = enum_cast<vendor_b::Status>(vendor_a::Status::Busy);
+    std::cout << static_cast<int>(b_status) << std::endl;
+
+    vendor_a::Status a_status = enum_cast<vendor_a::Status>(vendor_b::Status::Down);
+    std::cout << static_cast<int>(a_status) << std::endl;
+
+    return 0;
+}
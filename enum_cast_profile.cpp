@@ -0,0 +1,61 @@
+/*
+ * enum_cast_profile.cpp - Example usage of the conversion counters
+ *
+ * An instrumented category counts a few hits and misses, some of them on a
+ * thread that exits before the dump, and the totals are checked and printed.
+ */
+
+#include <enum_cast_profile.hpp>
+
+#include <iostream>
+#include <thread>
+
+namespace lib_a {
+    enum class Color { Red = 3, Green = 4, Blue = 5 };
+}
+
+namespace lib_b {
+    enum class Color { Red, Green, Blue, Yellow };
+}
+
+struct EnumColorTag {};
+template <> struct enum_category<lib_a::Color> { using type = EnumColorTag; };
+template <> struct enum_category<lib_b::Color> { using type = EnumColorTag; };
+
+template <>
+struct enum_mapping_traits<EnumColorTag>
+{
+    using instrumentation = enum_cast_counters;
+    using mapping_type = std::tuple<lib_a::Color, lib_b::Color>;
+    constexpr static mapping_type mappings[] = {
+        { lib_a::Color::Red, lib_b::Color::Red },
+        { lib_a::Color::Green, lib_b::Color::Green },
+        { lib_a::Color::Blue, lib_b::Color::Blue }
+    };
+};
+
+int main()
+{
+    // Three hits and one miss: Yellow has no lib_a color
+    for (lib_b::Color color : { lib_b::Color::Red, lib_b::Color::Green, lib_b::Color::Yellow, lib_b::Color::Blue }) {
+        enum_cast<lib_a::Color>(color);
+    }
+    // Counts of an exited thread are kept
+    std::thread([] {
+        enum_cast<lib_b::Color>(lib_a::Color::Green);
+        try_enum_cast<lib_b::Color>(static_cast<lib_a::Color>(9));
+    }).join();
+    enum_cast<lib_a::Color>(lib_b::Color::Yellow);
+
+    auto profile = enum_cast_profile();
+    if (profile.size() != 2 || profile[0].source != "lib_b::Color" || profile[0].calls != 5 ||
+        profile[0].misses != 2 || profile[1].source != "lib_a::Color" || profile[1].calls != 2 ||
+        profile[1].misses != 1) {
+        std::cerr << "unexpected counts" << std::endl;
+        enum_cast_profile_dump(std::cerr);
+        return 1;
+    }
+
+    enum_cast_profile_dump(std::cout);
+    return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * enum_cast_registry.cpp - Example usage of mappings registered at run time
+ *
+ * The rows would normally come from configuration or a plugin; here they are
+ * sparse codes including 0, which the registry serves through a perfect hash.
+ */
+
+#include <enum_cast_registry.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace plugin {
+    enum class Code : std::int32_t {};
+}
+
+namespace lib_a {
+    enum class Code { None, Io, Timeout, Denied };
+}
+
+struct PluginCodes {};
+using registry = enum_cast_registry<PluginCodes, plugin::Code, lib_a::Code>;
+
+int main()
+{
+    std::vector<registry::row_type> rows;
+    for (int i = 0; i < 16; ++i) {
+        rows.push_back({ static_cast<plugin::Code>(i * 102947), static_cast<lib_a::Code>(i % 4) });
+    }
+    registry::publish(rows, lib_a::Code::None);
+
+    // Too sparse for a dense table; a sorted array here would mean the perfect hash failed to build
+    if (registry::strategy() != enum_lookup_strategy::perfect_hash) {
+        std::cerr << "expected a perfect hash" << std::endl;
+        return 1;
+    }
+    for (const auto& [src, dst] : rows) {
+        if (try_registered_enum_cast<PluginCodes, lib_a::Code>(src) != dst) {
+            std::cerr << "lookup of " << static_cast<int>(src) << " failed" << std::endl;
+            return 1;
+        }
+    }
+    std::cout << static_cast<int>(registered_enum_cast<PluginCodes, lib_a::Code>(plugin::Code { 205894 })) << std::endl;
+    std::cout << static_cast<int>(registered_enum_cast<PluginCodes, lib_a::Code>(plugin::Code { 1 })) << std::endl;
+    return 0;
+}
@@ -1,66 +1,12 @@
 /*
- * enum_flag_bits_cast.h - Utility for safely casting between different enum types
- *
- * This header provides a type-safe mechanism for converting between enum values
- * from different libraries that represent the same logical concepts.
- * 
- * Key components:
- * - EnumConcept: Ensures template parameters are enum types
- * - MappingTraitsConcept: Validates mapping trait structures
- * - enum_category: Associates enums with their conceptual category
- * - enum_mapping_traits: Defines mappings between enum values
- * - enum_flag_bits_cast: Performs the actual enum flag bits conversion
+ * enum_flag_bits_cast.cpp - Example usage of enum_flag_bits_cast
  */
 
-#include <ranges>
-#include <type_traits>
+#include <enum_cast.hpp>
 
-template <typename T>
-concept EnumConcept = std::is_enum_v<T>;
-
-template <typename T>
-concept EnumMappingTraitsConcept = requires {
-    typename T::mapping_type;
-    { T::mappings } -> std::ranges::range;
-    { *std::begin(T::mappings) } -> std::convertible_to<typename T::mapping_type>;
-};
-
-template <EnumConcept Enum>
-struct enum_category;
-
-template <EnumConcept Enum>
-using enum_category_t = typename enum_category<Enum>::type;
-
-template <typename Tag>
-struct enum_mapping_traits;
-
-
-/**
- * @brief Converts bitwise flag enum values from one type to another within the same category
- * @tparam Dst The destination enum type
- * @tparam Src The source enum type
- * @param src The source enum flags value to convert
- * @return The equivalent enum flags value in the destination type
- * @note Source and destination enums must belong to the same category
- * @note Each bit position in the source is mapped to its corresponding bit in the destination
- * @note If a bit has no mapping, it will be dropped in the conversion
- */
-template <EnumConcept Dst, EnumConcept Src>
-constexpr Dst enum_flag_bits_cast(Src src)
-{
-    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
-                 "Source and destination enums must be of the same category");
-    using Category = enum_category_t<Src>;
-    using MappingTraits = enum_mapping_traits<Category>;
-    using UnderlyingType = std::underlying_type_t<Dst>;
-    UnderlyingType dst;
-    for (const auto& mapping : MappingTraits::mappings) {
-        if (std::get<Src>(mapping) & src) {
-            dst |= static_cast<UnderlyingType>(std::get<Dst>(mapping));
-        }
-    }
-    return static_cast<Dst>(dst);
-}
+#include <array>
+#include <bitset>
+#include <iostream>
 
 namespace lib_a {
     enum Permission
@@ -88,17 +34,11 @@ namespace lib_b {
 
 /*
  * It is important to ensure that the result of bitwise operations on enums is of the enum type, not an int type.
- * In other words, if the corresponding library does not implement this, it needs to be manually implemented.
+ * When the corresponding library does not provide such operators, opt its enums in to the ones of enum_flags.
 */
-
-template <EnumConcept Enum>
-Enum operator|(Enum a, Enum b)
-{
-    using UnderlyingType = std::underlying_type_t<Enum>;
-    return static_cast<Enum>(static_cast<UnderlyingType>(a) | static_cast<UnderlyingType>(b));
-}
-
-#include <tuple>
+template <> struct enum_flags_enabled<lib_a::Permission> : std::true_type {};
+template <> struct enum_flags_enabled<lib_b::Permission> : std::true_type {};
+using namespace enum_flags;
 
 struct PermissionTag {};
 template <> struct enum_category<lib_a::Permission> { using type = PermissionTag; };
@@ -116,9 +56,67 @@ struct enum_mapping_traits<PermissionTag>
     };
 };
 
+// Conversions are constant expressions, whichever kernel the mapping selects
+static_assert(enum_flag_bits_cast<lib_a::Permission>(lib_b::READ | lib_b::WRITE) == lib_a::ReadWrite);
+static_assert(enum_flag_bits_cast<lib_b::Permission>(lib_a::All) == (lib_b::READ | lib_b::WRITE | lib_b::EXECUTE));
+static_assert(enum_flag_bits_cast<lib_b::Permission>(lib_a::None) == lib_b::NONE);
 
-#include <iostream>
-#include <bitset>
+// Flags of different widths and signedness: the sign bit of an int enum is an ordinary flag
+namespace lib_c {
+    enum class Capability : std::uint8_t { None = 0, Read = 1 << 0, Write = 1 << 1, Audit = 1 << 2, Admin = 1 << 7,
+                                           ReadWrite = Read | Write };
+}
+namespace lib_d {
+    enum class Capability : std::int64_t { None = 0, Read = 1ll << 32, Write = 1ll << 33, Modify = 1ll << 34,
+                                           Admin = std::int64_t(1ull << 63) };
+}
+
+struct CapabilityTag {};
+template <> struct enum_category<lib_c::Capability> { using type = CapabilityTag; };
+template <> struct enum_category<lib_d::Capability> { using type = CapabilityTag; };
+
+template <>
+struct enum_mapping_traits<CapabilityTag>
+{
+    using mapping_type = std::tuple<lib_c::Capability, lib_d::Capability>;
+    constexpr static mapping_type mappings[] = {
+        {lib_c::Capability::Read, lib_d::Capability::Read},
+        {lib_c::Capability::Write, lib_d::Capability::Write},
+        {lib_c::Capability::Admin, lib_d::Capability::Admin},
+        // A composite row: ReadWrite becomes Modify alone, consuming both of its bits
+        {lib_c::Capability::ReadWrite, lib_d::Capability::Modify},
+    };
+};
+
+static_assert(enum_flag_bits_cast<lib_d::Capability>(lib_c::Capability::Admin) == lib_d::Capability::Admin);
+static_assert(enum_flag_bits_cast<lib_c::Capability>(lib_d::Capability::Admin) == lib_c::Capability::Admin);
+static_assert(enum_flag_bits_cast<lib_d::Capability>(lib_c::Capability::ReadWrite) == lib_d::Capability::Modify);
+
+// Lossy translations: Audit has no row, so the checked cast reports it and the strict cast rejects the value
+constexpr auto audited = enum_flag_bits_cast_checked<lib_d::Capability>(
+    static_cast<lib_c::Capability>(std::uint8_t(lib_c::Capability::Read) | std::uint8_t(lib_c::Capability::Audit)));
+static_assert(audited.value == lib_d::Capability::Read && audited.unmapped == lib_c::Capability::Audit);
+static_assert(!try_enum_flag_bits_cast<lib_d::Capability>(
+    static_cast<lib_c::Capability>(std::uint8_t(lib_c::Capability::Admin) | std::uint8_t(lib_c::Capability::Audit))));
+constexpr auto consumed = enum_flag_bits_cast_checked<lib_d::Capability>(lib_c::Capability::ReadWrite);
+static_assert(consumed.value == lib_d::Capability::Modify && consumed.unmapped == lib_c::Capability::None);
+constexpr auto nothing = enum_flag_bits_cast_checked<lib_d::Capability>(lib_c::Capability::None);
+static_assert(nothing.value == lib_d::Capability::None && nothing.unmapped == lib_c::Capability::None);
+static_assert(try_enum_flag_bits_cast<lib_d::Capability>(lib_c::Capability::Admin) == lib_d::Capability::Admin);
+
+// A table of translated masks, folded by the compiler rather than filled at startup
+constexpr auto translated_permissions = [] {
+    constexpr std::array<lib_a::Permission, 4> roles = { lib_a::Read, lib_a::ReadWrite, lib_a::ReadExecute, lib_a::All };
+    std::array<lib_b::Permission, roles.size()> result {};
+    enum_flag_bits_cast_n<lib_b::Permission>(std::span<const lib_a::Permission>(roles), std::span<lib_b::Permission>(result));
+    return result;
+}();
+static_assert(translated_permissions[1] == (lib_b::READ | lib_b::WRITE));
+
+// A flags set keeps its operators without any using, and converts like its value
+constexpr flags<lib_a::Permission> read_write = flags<lib_a::Permission>(lib_a::Read) | lib_a::Write;
+static_assert(read_write.contains(lib_a::Write) && !read_write.intersects(lib_a::Execute));
+static_assert(enum_flag_bits_cast<lib_b::Permission>(read_write) == (lib_b::READ | lib_b::WRITE));
 
 template <typename E>
 void print_flag_enum(E value)
@@ -133,5 +131,8 @@ int main()
     print_flag_enum(a);
     lib_b::Permission b = enum_flag_bits_cast<lib_b::Permission>(lib_a::Permission::Read | lib_a::Permission::Write);
     print_flag_enum(b);
+    for (lib_b::Permission permission : translated_permissions) {
+        print_flag_enum(permission);
+    }
     return 0;
 }
\ No newline at end of file
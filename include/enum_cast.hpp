@@ -0,0 +1,3211 @@
+/*
+ * enum_cast.hpp - Utility for safely casting between different enum types
+ *
+ * This header provides a type-safe mechanism for converting between enum values
+ * from different libraries that represent the same logical concepts.
+ *
+ * Key components:
+ * - EnumConcept: Ensures template parameters are enum types
+ * - MappingTraitsConcept: Validates mapping trait structures
+ * - enum_category: Associates enums with their conceptual category
+ * - enum_mapping_traits: Defines mappings between enum values
+ * - enum_mapping_*_v: Compile-time validation of the mapping tables
+ * - enum_round_trips: Whether two enums convert into each other and back unchanged
+ * - enum_mappings_by_name: Derives mappings by pairing enumerator names
+ * - enum_cast: Performs the actual enum conversion
+ * - try_enum_cast, expected_enum_cast: Report a missing mapping instead of
+ *   returning the category's fallback value
+ * - enum_cast_all: Converts into every enum of the category with one lookup
+ * - enum_cast_via, try_enum_cast_via: Convert across two categories through a
+ *   shared enum, folded into one table
+ * - enum_cast_n, views::enum_cast: Convert whole spans and ranges
+ * - enum_to_string, enum_from_string: Name lookups through an optional
+ *   std::string_view column of the mappings
+ * - enum_from_string_n, enum_from_string_split: Parse whole columns of names
+ * - enum_flag_bits_cast: Performs the actual enum flag bits conversion
+ * - enum_flag_bits_cast_checked, try_enum_flag_bits_cast: Report or reject
+ *   source bits without a mapping
+ * - enum_flag_bits_cast_n: Converts whole spans of flag values
+ * - enum_flags_enabled, enum_flags::flags: Opt-in bitwise operators and a flag
+ *   set wrapper that keep flag arithmetic in the enum type
+ * - enum_cast_operation: Conversions a category's instrumentation policy records
+ *
+ * Lookup backends for enum_cast (enum_lookup_strategy):
+ * - Dense table: direct-indexed array offset by the smallest source value,
+ *   used when the source values are packed closely enough; slots are held in
+ *   the narrowest integer type that fits the destination values
+ * - Masked dense table: a dense table padded with fallback slots to a power of
+ *   two, looked up without a bounds branch; only used when requested
+ * - Perfect hash: minimal perfect hash over the source values, used for wide
+ *   sparse columns
+ * - Sorted array: binary search, used for very long columns and when a
+ *   perfect hash cannot be built
+ * - Linear scan: first-match search over the mappings, used for short columns
+ * Categories whose enum columns are pairwise bijective share one index per
+ * column, from enum value to row, between all destinations (shares_row_index).
+ *
+ * Conversion kernels for enum_flag_bits_cast (enum_flag_kernel):
+ * - Shift: every mapped bit moves by the same distance, one shift and one mask
+ * - Bit masks: a precomputed destination mask per mapped source bit, ORed
+ *   together without branches
+ * - Byte tables: one 256-entry table per source byte holding mapped bits, for
+ *   wide flag enums where the per-bit loop gets long and narrow ones packed with
+ *   mapped bits
+ * - Extract/deposit: BMI2 pext and pdep, for mappings spread over many bytes
+ *   that keep the order of the bits
+ * Source and destination may differ in width and signedness; flag values are
+ * handled as their unsigned counterparts, so a sign bit is an ordinary flag.
+ *
+ * The header is self-contained and has no configuration macros of its own, so
+ * it can be used as a precompiled header as is, or through the named module
+ * enum_cast built from modules/enum_cast_core.cppm.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_expected)
+#include <expected>
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+template <typename T>
+concept EnumConcept = std::is_enum_v<T>;
+
+template <typename T>
+concept EnumMappingTraitsConcept = requires {
+    typename T::mapping_type;
+    { T::mappings } -> std::ranges::range;
+    { *std::begin(T::mappings) } -> std::convertible_to<typename T::mapping_type>;
+};
+
+// Trait detection - determines which category an enum belongs to
+template <EnumConcept Enum>
+struct enum_category;
+
+template <EnumConcept Enum>
+using enum_category_t = typename enum_category<Enum>::type;
+
+// Enum mapping traits declaration - implemented per enum category
+template <typename Tag>
+struct enum_mapping_traits;
+
+// Error reported by expected_enum_cast when a source value has no mapping
+struct unmapped_t
+{
+    explicit unmapped_t() = default;
+};
+inline constexpr unmapped_t unmapped {};
+
+/**
+ * Conversions reported to a category's instrumentation policy, declared in its
+ * enum_mapping_traits as `using instrumentation = Policy;`
+ *
+ * The policy provides a static member function template
+ * `template <typename Category, EnumConcept Src, EnumConcept Dst> static void record(enum_cast_operation, bool missed)`
+ * that is called once per conversion evaluated at run time; see
+ * enum_cast_counters in enum_cast_profile.hpp. Categories without an
+ * instrumentation policy compile to the uninstrumented code.
+ */
+enum class enum_cast_operation
+{
+    enum_cast,      // enum_cast, try_enum_cast, expected_enum_cast; missed when the source has no mapping
+    flag_bits_cast, // enum_flag_bits_cast and its checked forms; missed when source bits were dropped
+};
+
+/**
+ * Lookup strategies a category can request through
+ * `constexpr static enum_lookup_strategy lookup_strategy` in its enum_mapping_traits
+ */
+enum class enum_lookup_strategy
+{
+    automatic,          // chosen per source column by enum_cast_detail::select_lookup_strategy
+    linear_scan,        // first-match search over the mappings
+    dense_table,        // direct-indexed array offset by the smallest source value
+    sorted_array,       // binary search over the sorted source values
+    perfect_hash,       // minimal perfect hash over the source values
+    masked_dense_table, // dense table padded to a power of two, looked up without a bounds branch
+};
+
+namespace enum_cast_detail {
+
+/*
+ * A dense table is preferred while it stays small in absolute terms or keeps at
+ * least one mapped entry per `dense_table_max_slots_per_row` slots.
+ */
+inline constexpr std::uint64_t dense_table_max_slots_per_row = 4;
+inline constexpr std::uint64_t dense_table_small_size = 64;
+// Sparse columns this short are scanned; hashing does not pay off below this
+inline constexpr std::size_t linear_scan_max_rows = 8;
+// Longer sparse columns use a sorted array, keeping the compile-time hash search within constexpr limits
+inline constexpr std::size_t perfect_hash_max_rows = 4096;
+
+template <typename MappingTraits>
+inline constexpr std::size_t mapping_rows = std::ranges::size(MappingTraits::mappings);
+
+/*
+ * Tables laid out ahead of time (see tools/enum_cast_gen.py) may also provide,
+ * per enum of the category:
+ * - `constexpr static auto column(std::type_identity<Enum>)`: the Enum column
+ *   as underlying values in row order
+ * - `constexpr static auto sorted_rows(std::type_identity<Enum>)`: the row
+ *   indices ordered by (Enum value, row)
+ * so that neither has to be rebuilt from the tuple rows during compilation.
+ */
+template <typename MappingTraits, typename Enum>
+concept PrecomputedColumnConcept = requires {
+    { MappingTraits::column(std::type_identity<Enum> {}) } -> std::ranges::range;
+};
+
+template <typename MappingTraits, typename Enum>
+concept PrecomputedSortedRowsConcept = requires {
+    { MappingTraits::sorted_rows(std::type_identity<Enum> {}) } -> std::ranges::range;
+};
+
+/**
+ * One column of a mapping table as a flat array of underlying values
+ *
+ * Built once per category and enum type; every table and kernel below reads
+ * the columns it needs from here rather than unpacking the tuple rows again
+ * for each Src/Dst pair.
+ */
+template <typename MappingTraits, EnumConcept Enum>
+struct mapping_column
+{
+    using underlying_type = std::underlying_type_t<Enum>;
+
+    constexpr static auto values = [] {
+        std::array<underlying_type, mapping_rows<MappingTraits>> result {};
+        if constexpr (PrecomputedColumnConcept<MappingTraits, Enum>) {
+            constexpr auto column = MappingTraits::column(std::type_identity<Enum> {});
+            static_assert(std::ranges::size(column) == mapping_rows<MappingTraits>,
+                          "A precomputed column must hold one value per mapping row");
+            // A value the underlying type cannot hold would lose bits, flag bits among them, on the way in
+            if constexpr (std::is_integral_v<std::ranges::range_value_t<decltype(column)>>) {
+                static_assert(std::ranges::all_of(column, [](auto value) { return std::in_range<underlying_type>(value); }),
+                              "Every value of a precomputed column must fit the enum's underlying type");
+            }
+            std::ranges::copy(column, result.begin());
+        } else {
+            std::size_t row = 0;
+            for (const auto& mapping : MappingTraits::mappings) {
+                result[row++] = static_cast<underlying_type>(std::get<Enum>(mapping));
+            }
+        }
+        return result;
+    }();
+
+    constexpr static Enum at(std::size_t row)
+    {
+        return static_cast<Enum>(values[row]);
+    }
+};
+
+/**
+ * Row index of a mapping table, usable wherever a Dst enum is expected
+ *
+ * A lookup keyed by Src with mapping_row as its Dst yields the first row holding
+ * the source value, which lets per-row data such as names share the backends.
+ * Unmapped sources yield one past the last row.
+ */
+enum class mapping_row : std::size_t
+{
+};
+
+template <typename MappingTraits>
+struct mapping_column<MappingTraits, mapping_row>
+{
+    using underlying_type = std::size_t;
+
+    constexpr static auto values = [] {
+        std::array<underlying_type, mapping_rows<MappingTraits>> result {};
+        for (std::size_t row = 0; row < result.size(); ++row) {
+            result[row] = row;
+        }
+        return result;
+    }();
+
+    constexpr static mapping_row at(std::size_t row)
+    {
+        return static_cast<mapping_row>(row);
+    }
+};
+
+/**
+ * Value range covered by the Src column of a mapping table
+ *
+ * Offsets are computed in the unsigned counterpart of the underlying type, so
+ * the distance between any two values is well defined for signed enums too.
+ */
+template <typename MappingTraits, EnumConcept Src>
+struct source_range
+{
+    using underlying_type = std::underlying_type_t<Src>;
+    using offset_type = std::make_unsigned_t<underlying_type>;
+
+    constexpr static auto bounds = [] {
+        const auto& column = mapping_column<MappingTraits, Src>::values;
+        std::array<underlying_type, 2> result = { column[0], column[0] };
+        for (auto value : column) {
+            result[0] = value < result[0] ? value : result[0];
+            result[1] = value > result[1] ? value : result[1];
+        }
+        return result;
+    }();
+    constexpr static underlying_type min = bounds[0];
+    constexpr static underlying_type max = bounds[1];
+    // Number of slots minus one; cannot overflow even when the range spans the whole type
+    constexpr static std::uint64_t extent = static_cast<offset_type>(static_cast<offset_type>(max) - static_cast<offset_type>(min));
+
+    constexpr static offset_type offset_of(underlying_type value)
+    {
+        return static_cast<offset_type>(static_cast<offset_type>(value) - static_cast<offset_type>(min));
+    }
+
+    constexpr static offset_type offset_of(Src src)
+    {
+        return offset_of(static_cast<underlying_type>(src));
+    }
+};
+
+/**
+ * Distinct values of the Src column in ascending order, each paired with the
+ * first row it occurs in
+ */
+template <typename MappingTraits, EnumConcept Src>
+struct source_keys
+{
+    using underlying_type = std::underlying_type_t<Src>;
+
+    struct entry
+    {
+        underlying_type key;
+        std::size_t row;
+
+        constexpr bool operator<(const entry& other) const
+        {
+            return key < other.key || (key == other.key && row < other.row);
+        }
+    };
+
+    constexpr static std::size_t rows = mapping_rows<MappingTraits>;
+
+    constexpr static auto sorted_rows = [] {
+        const auto& column = mapping_column<MappingTraits, Src>::values;
+        std::array<entry, rows> entries {};
+        if constexpr (PrecomputedSortedRowsConcept<MappingTraits, Src>) {
+            constexpr auto order = MappingTraits::sorted_rows(std::type_identity<Src> {});
+            static_assert(std::ranges::size(order) == rows, "Precomputed sorted rows must list every mapping row");
+            std::size_t i = 0;
+            for (auto row : order) {
+                entries[i++] = { column[row], static_cast<std::size_t>(row) };
+            }
+        } else {
+            for (std::size_t row = 0; row < rows; ++row) {
+                entries[row] = { column[row], row };
+            }
+        }
+        // Tables generated in key order, or listed that way by hand, skip the sort
+        if (!PrecomputedSortedRowsConcept<MappingTraits, Src> && !std::is_sorted(entries.begin(), entries.end())) {
+            std::sort(entries.begin(), entries.end());
+        }
+        return entries;
+    }();
+
+    // Strictly ascending also rules out a row listed twice, making the order a permutation
+    static_assert(!PrecomputedSortedRowsConcept<MappingTraits, Src> ||
+                  std::adjacent_find(sorted_rows.begin(), sorted_rows.end(),
+                                    [](const entry& a, const entry& b) { return !(a < b); }) == sorted_rows.end(),
+                  "Precomputed sorted rows must be ordered by (value, row)");
+
+    constexpr static std::size_t size = [] {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < rows; ++i) {
+            count += i == 0 || sorted_rows[i].key != sorted_rows[i - 1].key;
+        }
+        return count;
+    }();
+
+    // Rows repeating a source value that an earlier row already holds
+    constexpr static std::size_t duplicates = rows - size;
+
+    constexpr static auto entries = [] {
+        if constexpr (duplicates == 0) {
+            return sorted_rows;
+        } else {
+            std::array<entry, size> unique {};
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < rows; ++i) {
+                if (i == 0 || sorted_rows[i].key != sorted_rows[i - 1].key) {
+                    unique[count++] = sorted_rows[i];
+                }
+            }
+            return unique;
+        }
+    }();
+};
+
+/**
+ * Whether every row holding a given Src value agrees on the Dst value, so that
+ * the result does not depend on which duplicate row a lookup finds first
+ */
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+consteval bool is_functional()
+{
+    using keys = source_keys<MappingTraits, Src>;
+    if constexpr (keys::duplicates != 0) {
+        for (std::size_t i = 1; i < keys::rows; ++i) {
+            const auto& previous = keys::sorted_rows[i - 1];
+            const auto& current = keys::sorted_rows[i];
+            const auto& column = mapping_column<MappingTraits, Dst>::values;
+            if (previous.key == current.key && column[previous.row] != column[current.row]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename MappingTraits>
+consteval bool allows_duplicate_keys()
+{
+    if constexpr (requires { { MappingTraits::allow_duplicate_keys } -> std::convertible_to<bool>; }) {
+        return MappingTraits::allow_duplicate_keys;
+    } else {
+        return false;
+    }
+}
+
+constexpr std::uint64_t mix64(std::uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+/*
+ * Hash of a key for the perfect hashes: the offset keeps small keys, zero
+ * above all, from hashing to small values, which mix64 leaves fixed
+ */
+constexpr std::uint64_t hash_key(std::uint64_t key)
+{
+    return mix64(key + 0x9e3779b97f4a7c15ull);
+}
+
+// Maps a 32-bit hash onto [0, bound) without a division
+constexpr std::uint32_t reduce(std::uint32_t hash, std::uint32_t bound)
+{
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(hash) * bound) >> 32);
+}
+
+/*
+ * Hash-and-displace construction of a minimal perfect hash, shared by the
+ * compile-time tables and those built at run time: keys, given as their 64-bit
+ * hashes, are spread over buckets (two keys per bucket on average) by the high
+ * half of their hash, and each bucket, largest first, searches for a seed that
+ * places all of its keys into still-free slots.
+ */
+using hash_displace_seed = std::uint16_t;
+
+inline constexpr std::uint32_t hash_displace_max_seed = 1u << 16;
+
+constexpr std::size_t hash_displace_buckets(std::size_t size)
+{
+    return (size + 1) / 2;
+}
+
+constexpr std::uint32_t hash_displace_bucket(std::uint64_t hash, std::size_t bucket_count)
+{
+    return reduce(static_cast<std::uint32_t>(hash >> 32), static_cast<std::uint32_t>(bucket_count));
+}
+
+// Each seed remixes the whole hash, so keys that collide under one seed are independent under the next
+constexpr std::uint32_t hash_displace_slot(std::uint64_t hash, std::uint32_t seed, std::size_t size)
+{
+    auto remixed = mix64(hash ^ (static_cast<std::uint64_t>(seed) + 1) * 0x9e3779b97f4a7c15ull);
+    return reduce(static_cast<std::uint32_t>(remixed), static_cast<std::uint32_t>(size));
+}
+
+/*
+ * Fills seeds (one per bucket) and slots (the index of the key stored in each
+ * slot, one per key), or returns false when some bucket finds no seed
+ */
+constexpr bool hash_displace_place(std::span<const std::uint64_t> hashes, std::span<hash_displace_seed> seeds,
+                                   std::span<std::size_t> slots)
+{
+    const std::size_t size = hashes.size();
+    const std::size_t bucket_count = seeds.size();
+    // Group the keys by bucket (counting sort)
+    std::vector<std::size_t> bucket_start(bucket_count + 1);
+    for (std::size_t i = 0; i < size; ++i) {
+        ++bucket_start[hash_displace_bucket(hashes[i], bucket_count) + 1];
+    }
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        bucket_start[bucket + 1] += bucket_start[bucket];
+    }
+    std::vector<std::size_t> grouped(size);
+    std::vector<std::size_t> filled(bucket_count);
+    for (std::size_t i = 0; i < size; ++i) {
+        auto bucket = hash_displace_bucket(hashes[i], bucket_count);
+        grouped[bucket_start[bucket] + filled[bucket]++] = i;
+    }
+
+    std::vector<std::size_t> order(bucket_count);
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        order[bucket] = bucket;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return filled[a] > filled[b] || (filled[a] == filled[b] && a < b);
+    });
+
+    std::vector<bool> taken(size);
+    std::vector<std::uint32_t> candidate(size);
+    for (std::size_t bucket : order) {
+        const std::size_t* members = grouped.data() + bucket_start[bucket];
+        const std::size_t member_count = filled[bucket];
+        bool placed = member_count == 0;
+        for (std::uint32_t seed = 0; !placed && seed < hash_displace_max_seed; ++seed) {
+            placed = true;
+            for (std::size_t m = 0; placed && m < member_count; ++m) {
+                candidate[m] = hash_displace_slot(hashes[members[m]], seed, size);
+                placed = !taken[candidate[m]];
+                for (std::size_t other = 0; placed && other < m; ++other) {
+                    placed = candidate[other] != candidate[m];
+                }
+            }
+            if (placed) {
+                seeds[bucket] = static_cast<hash_displace_seed>(seed);
+                for (std::size_t m = 0; m < member_count; ++m) {
+                    taken[candidate[m]] = true;
+                    slots[candidate[m]] = members[m];
+                }
+            }
+        }
+        if (!placed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Minimal perfect hash over Size keys, given as their 64-bit hashes
+ *
+ * A lookup is one hash, one seed load, a remix of hash and seed and one key compare,
+ * over exactly `size` slots.
+ */
+template <std::size_t Size>
+struct hash_displace
+{
+    constexpr static std::size_t size = Size;
+    constexpr static std::size_t bucket_count = hash_displace_buckets(size);
+    using seed_type = hash_displace_seed;
+
+    constexpr static std::uint32_t bucket_of(std::uint64_t hash)
+    {
+        return hash_displace_bucket(hash, bucket_count);
+    }
+
+    constexpr static std::uint32_t slot_of(std::uint64_t hash, std::uint32_t seed)
+    {
+        return hash_displace_slot(hash, seed, size);
+    }
+
+    constexpr static std::uint32_t slot_of(std::uint64_t hash, const std::array<seed_type, bucket_count>& seeds)
+    {
+        return slot_of(hash, seeds[bucket_of(hash)]);
+    }
+
+    struct layout
+    {
+        bool built = false;
+        std::array<seed_type, bucket_count> seeds {};
+        // Index of the key stored in each slot
+        std::array<std::size_t, size> slots {};
+    };
+
+    constexpr static layout build(const std::array<std::uint64_t, size>& hashes)
+    {
+        layout result;
+        result.built = hash_displace_place(hashes, result.seeds, result.slots);
+        return result;
+    }
+};
+
+// Perfect hash over the distinct values of the Src column; slots index keys::entries
+template <typename MappingTraits, EnumConcept Src>
+struct perfect_hash_index : hash_displace<source_keys<MappingTraits, Src>::size>
+{
+    using keys = source_keys<MappingTraits, Src>;
+    using underlying_type = typename keys::underlying_type;
+    using base = hash_displace<keys::size>;
+
+    constexpr static std::uint64_t hash_of(underlying_type key)
+    {
+        return hash_key(static_cast<std::uint64_t>(key));
+    }
+
+    constexpr static typename base::layout index = [] {
+        std::array<std::uint64_t, keys::size> hashes {};
+        for (std::size_t i = 0; i < keys::size; ++i) {
+            hashes[i] = hash_of(keys::entries[i].key);
+        }
+        return base::build(hashes);
+    }();
+
+    constexpr static bool built = index.built;
+};
+
+template <typename MappingTraits, EnumConcept Src>
+constexpr bool use_dense_table()
+{
+    constexpr std::uint64_t rows = mapping_rows<MappingTraits>;
+    constexpr std::uint64_t extent = source_range<MappingTraits, Src>::extent;
+    return extent < dense_table_small_size || extent / dense_table_max_slots_per_row < rows;
+}
+
+/**
+ * Strategy used for lookups keyed by the Src column: the category's
+ * `lookup_strategy` when it names one, otherwise a dense table for packed
+ * value ranges, a scan for short columns, a sorted array for very long ones
+ * and a perfect hash for the rest.
+ * A perfect hash that cannot be constructed degrades to a sorted array when
+ * chosen automatically, and fails to compile when the category requested it.
+ */
+template <typename MappingTraits, EnumConcept Src>
+constexpr enum_lookup_strategy select_lookup_strategy()
+{
+    constexpr auto requested = [] {
+        if constexpr (requires { { MappingTraits::lookup_strategy } -> std::convertible_to<enum_lookup_strategy>; }) {
+            return static_cast<enum_lookup_strategy>(MappingTraits::lookup_strategy);
+        } else {
+            return enum_lookup_strategy::automatic;
+        }
+    }();
+    constexpr auto strategy = [] {
+        if constexpr (mapping_rows<MappingTraits> == 0) {
+            return enum_lookup_strategy::linear_scan;
+        } else if constexpr (requested != enum_lookup_strategy::automatic) {
+            return requested;
+        } else if constexpr (use_dense_table<MappingTraits, Src>()) {
+            return enum_lookup_strategy::dense_table;
+        } else if constexpr (mapping_rows<MappingTraits> <= linear_scan_max_rows) {
+            return enum_lookup_strategy::linear_scan;
+        } else if constexpr (mapping_rows<MappingTraits> > perfect_hash_max_rows) {
+            return enum_lookup_strategy::sorted_array;
+        } else {
+            return enum_lookup_strategy::perfect_hash;
+        }
+    }();
+    if constexpr (strategy == enum_lookup_strategy::perfect_hash) {
+        constexpr bool built = perfect_hash_index<MappingTraits, Src>::built;
+        static_assert(built || requested != enum_lookup_strategy::perfect_hash,
+                      "The category requests lookup_strategy = perfect_hash, but no perfect hash could be built "
+                      "over this source column; request another lookup strategy");
+        return built ? strategy : enum_lookup_strategy::sorted_array;
+    } else {
+        return strategy;
+    }
+}
+
+/**
+ * Value returned for unmapped sources: the Dst entry of the category's
+ * `default_mapping` row when it declares one, static_cast<Dst>(0) otherwise,
+ * and one past the last row for mapping_row
+ */
+template <typename MappingTraits, EnumConcept Dst>
+constexpr Dst fallback_value()
+{
+    if constexpr (std::is_same_v<Dst, mapping_row>) {
+        return static_cast<mapping_row>(mapping_rows<MappingTraits>);
+    } else if constexpr (requires { { MappingTraits::default_mapping } -> std::convertible_to<typename MappingTraits::mapping_type>; }) {
+        return std::get<Dst>(MappingTraits::default_mapping);
+    } else {
+        return static_cast<Dst>(0);
+    }
+}
+
+/*
+ * Every backend below provides `lookup`, returning the fallback value on a miss,
+ * and `find`, returning std::nullopt instead; both take a single pass.
+ */
+
+// Whether value is representable in Packed, for any integral underlying type including char and bool
+template <typename Packed, typename Underlying>
+constexpr bool fits_integer(Underlying value)
+{
+    if constexpr (std::is_signed_v<Underlying>) {
+        if (value < 0) {
+            return std::is_signed_v<Packed> && static_cast<std::int64_t>(value) >= std::numeric_limits<Packed>::min();
+        }
+    }
+    return static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<Packed>::max());
+}
+
+// Smallest integer type holding every value in [Min, Max], unsigned first; Underlying when none is narrower
+template <typename Underlying, Underlying Min, Underlying Max>
+struct packed_integer
+{
+    template <typename Packed>
+    constexpr static bool fits = sizeof(Packed) < sizeof(Underlying) && fits_integer<Packed>(Min) && fits_integer<Packed>(Max);
+
+    using type = std::conditional_t<fits<std::uint8_t>, std::uint8_t,
+                 std::conditional_t<fits<std::int8_t>, std::int8_t,
+                 std::conditional_t<fits<std::uint16_t>, std::uint16_t,
+                 std::conditional_t<fits<std::int16_t>, std::int16_t,
+                 std::conditional_t<fits<std::uint32_t>, std::uint32_t,
+                 std::conditional_t<fits<std::int32_t>, std::int32_t, Underlying>>>>>>;
+};
+
+/**
+ * Direct-indexed Src -> Dst table, offset by the smallest source value
+ *
+ * Slots without a mapping hold the fallback value, so `lookup` never needs to
+ * know whether a slot is mapped. When a source value occurs in several rows the
+ * first row wins, matching the linear scan.
+ *
+ * Slots are stored in the narrowest integer type that holds every Dst value of
+ * the table (storage_type), typically one byte, and which slots are mapped is
+ * kept as a bitmap, so that many tables share the cache.
+ *
+ * @tparam Masked Pads the table with fallback slots to a power of two larger
+ *         than the source range and folds out-of-range offsets onto the last
+ *         of them arithmetically, so `lookup` has no bounds branch to mispredict
+ */
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst, bool Masked = false>
+struct dense_table
+{
+    using range = source_range<MappingTraits, Src>;
+    using dst_underlying = std::underlying_type_t<Dst>;
+    using offset_type = typename range::offset_type;
+
+    constexpr static Dst fallback = fallback_value<MappingTraits, Dst>();
+
+    // Slots holding mapped source values
+    constexpr static std::size_t size = range::extent + 1;
+
+    // A range spanning the whole underlying type leaves no offset to fold
+    constexpr static bool spans_type = range::extent == std::numeric_limits<offset_type>::max();
+
+    // Slots in the table, at least one of them past the source range when Masked
+    constexpr static std::size_t slots = Masked && !spans_type ? std::bit_ceil(size + 1) : size;
+    constexpr static offset_type mask = static_cast<offset_type>(slots - 1);
+
+    // One bit per slot, set when some row maps it
+    constexpr static auto filled = [] {
+        std::array<std::uint64_t, (size + 63) / 64> result {};
+        for (auto value : mapping_column<MappingTraits, Src>::values) {
+            auto index = range::offset_of(value);
+            result[index / 64] |= std::uint64_t(1) << (index % 64);
+        }
+        return result;
+    }();
+
+    constexpr static bool has_holes = [] {
+        std::size_t count = 0;
+        for (auto word : filled) {
+            count += static_cast<std::size_t>(std::popcount(word));
+        }
+        return count != size;
+    }();
+
+    constexpr static bool is_filled(std::size_t index)
+    {
+        return (filled[index / 64] >> (index % 64)) & 1u;
+    }
+
+    // Slot values before packing
+    constexpr static auto unpacked = [] {
+        std::array<dst_underlying, slots> table {};
+        std::array<bool, size> assigned {};
+        table.fill(static_cast<dst_underlying>(fallback));
+        for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+            auto index = range::offset_of(mapping_column<MappingTraits, Src>::values[row]);
+            if (!assigned[index]) {
+                assigned[index] = true;
+                table[index] = static_cast<dst_underlying>(mapping_column<MappingTraits, Dst>::values[row]);
+            }
+        }
+        return table;
+    }();
+
+    constexpr static auto bounds = [] {
+        std::array<dst_underlying, 2> result = { unpacked[0], unpacked[0] };
+        for (auto value : unpacked) {
+            result[0] = value < result[0] ? value : result[0];
+            result[1] = value > result[1] ? value : result[1];
+        }
+        return result;
+    }();
+
+    using storage_type = typename packed_integer<dst_underlying, bounds[0], bounds[1]>::type;
+
+    // Trailing slots that keep a 32-bit load of the last slot, as the vector gathers do, in bounds
+    constexpr static std::size_t padding = sizeof(storage_type) < 4 ? 4 / sizeof(storage_type) - 1 : 0;
+
+    constexpr static auto values = [] {
+        std::array<storage_type, slots + padding> table {};
+        for (std::size_t i = 0; i < slots; ++i) {
+            table[i] = static_cast<storage_type>(unpacked[i]);
+        }
+        return table;
+    }();
+
+    constexpr static Dst at(std::size_t index)
+    {
+        return static_cast<Dst>(static_cast<dst_underlying>(values[index]));
+    }
+
+    constexpr static Dst lookup(Src src)
+    {
+        auto index = range::offset_of(src);
+        if constexpr (Masked) {
+            // An offset past the mask selects the all-ones index, a padding slot holding the fallback
+            auto beyond = static_cast<offset_type>(0) - static_cast<offset_type>(index > mask);
+            return at(static_cast<std::size_t>((index & mask) | (beyond & mask)));
+        } else {
+            return index < size ? at(index) : fallback;
+        }
+    }
+
+    constexpr static std::optional<Dst> find(Src src)
+    {
+        auto index = range::offset_of(src);
+        if (index < size && (!has_holes || is_filled(index))) {
+            return at(index);
+        }
+        return std::nullopt;
+    }
+
+    // Bytes of the arrays lookups read
+    constexpr static std::size_t footprint = sizeof(values) + (has_holes ? sizeof(filled) : 0);
+
+    // Whether the table can be held in one 16-byte pshufb operand
+    constexpr static bool fits_byte_shuffle = [] {
+        if (size > 16) {
+            return false;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            if (unpacked[i] < 0 || unpacked[i] > 0xff) {
+                return false;
+            }
+        }
+        return true;
+    }();
+
+    constexpr static auto byte_values = [] {
+        std::array<std::uint8_t, 16> result {};
+        if constexpr (fits_byte_shuffle) {
+            for (std::size_t i = 0; i < size; ++i) {
+                result[i] = static_cast<std::uint8_t>(unpacked[i]);
+            }
+        }
+        return result;
+    }();
+};
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+/*
+ * Vector kernels for dense tables with 32-bit source and destination enums.
+ * Each returns the number of elements converted; the caller finishes the tail.
+ * Out-of-range lanes produce the fallback value, the same as dense_table::lookup.
+ */
+template <typename Table>
+std::size_t dense_table_batch_simd(const void* src, void* dst, std::size_t count)
+{
+    const auto* in = static_cast<const std::uint8_t*>(src);
+    auto* out = static_cast<std::uint8_t*>(dst);
+    const auto min = static_cast<std::int32_t>(Table::range::min);
+    const auto size = static_cast<std::int32_t>(Table::size);
+    const auto sign = std::int32_t(0x80000000u);
+    const auto fallback = static_cast<std::int32_t>(Table::fallback);
+    std::size_t done = 0;
+#if defined(__AVX2__)
+    const __m256i fallback_v = _mm256_set1_epi32(fallback);
+    const __m256i min_v = _mm256_set1_epi32(min);
+    const __m256i bound_v = _mm256_set1_epi32(size ^ sign);
+    const __m256i sign_v = _mm256_set1_epi32(sign);
+    if constexpr (Table::fits_byte_shuffle) {
+        const __m256i table_v = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(Table::byte_values.data())));
+        // Only the low byte of each lane selects from the table, the others are zeroed
+        const __m256i high_v = _mm256_set1_epi32(std::int32_t(0x80808000u));
+        for (; done + 8 <= count; done += 8) {
+            __m256i index = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done * 4)), min_v);
+            __m256i in_range = _mm256_cmpgt_epi32(bound_v, _mm256_xor_si256(index, sign_v));
+            __m256i looked_up = _mm256_shuffle_epi8(table_v, _mm256_or_si256(index, high_v));
+            __m256i result = _mm256_blendv_epi8(fallback_v, looked_up, in_range);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done * 4), result);
+        }
+    } else {
+        using storage_type = typename Table::storage_type;
+        // Narrow slots are gathered as 32-bit words at their own stride and the high bytes
+        // dropped; the fallback fits storage_type too, so out-of-range lanes survive the widening
+        constexpr int stride = sizeof(storage_type);
+        constexpr int narrow_bits = 32 - 8 * stride;
+        const auto* table = reinterpret_cast<const int*>(Table::values.data());
+        for (; done + 8 <= count; done += 8) {
+            __m256i index = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done * 4)), min_v);
+            __m256i in_range = _mm256_cmpgt_epi32(bound_v, _mm256_xor_si256(index, sign_v));
+            __m256i result = _mm256_mask_i32gather_epi32(fallback_v, table, index, in_range, stride);
+            if constexpr (narrow_bits != 0) {
+                result = _mm256_slli_epi32(result, narrow_bits);
+                result = std::is_signed_v<storage_type> ? _mm256_srai_epi32(result, narrow_bits)
+                                                        : _mm256_srli_epi32(result, narrow_bits);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done * 4), result);
+        }
+    }
+#else
+    if constexpr (Table::fits_byte_shuffle) {
+        const __m128i fallback_v = _mm_set1_epi32(fallback);
+        const __m128i min_v = _mm_set1_epi32(min);
+        const __m128i bound_v = _mm_set1_epi32(size ^ sign);
+        const __m128i sign_v = _mm_set1_epi32(sign);
+        const __m128i table_v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Table::byte_values.data()));
+        const __m128i high_v = _mm_set1_epi32(std::int32_t(0x80808000u));
+        for (; done + 4 <= count; done += 4) {
+            __m128i index = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done * 4)), min_v);
+            __m128i in_range = _mm_cmplt_epi32(_mm_xor_si128(index, sign_v), bound_v);
+            // Out-of-range indices may alias table slots; blend the fallback over them
+            __m128i looked_up = _mm_shuffle_epi8(table_v, _mm_or_si128(index, high_v));
+            __m128i result = _mm_or_si128(_mm_and_si128(in_range, looked_up), _mm_andnot_si128(in_range, fallback_v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done * 4), result);
+        }
+    }
+#endif
+    return done;
+}
+#endif
+
+/**
+ * Sorted source values with the matching Dst values alongside, searched with
+ * a branchless binary search
+ */
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+struct sorted_array
+{
+    using keys = source_keys<MappingTraits, Src>;
+    using underlying_type = typename keys::underlying_type;
+
+    constexpr static auto sorted_keys = [] {
+        std::array<underlying_type, keys::size> result {};
+        for (std::size_t i = 0; i < keys::size; ++i) {
+            result[i] = keys::entries[i].key;
+        }
+        return result;
+    }();
+
+    constexpr static auto values = [] {
+        std::array<Dst, keys::size> result {};
+        for (std::size_t i = 0; i < keys::size; ++i) {
+            result[i] = mapping_column<MappingTraits, Dst>::at(keys::entries[i].row);
+        }
+        return result;
+    }();
+
+    constexpr static Dst fallback = fallback_value<MappingTraits, Dst>();
+
+    constexpr static std::size_t footprint = sizeof(sorted_keys) + sizeof(values);
+
+    constexpr static std::size_t search(Src src)
+    {
+        auto key = static_cast<underlying_type>(src);
+        std::size_t base = 0;
+        for (std::size_t length = keys::size; length > 1; length -= length / 2) {
+            std::size_t half = length / 2;
+            base = sorted_keys[base + half] <= key ? base + half : base;
+        }
+        return base;
+    }
+
+    constexpr static Dst lookup(Src src)
+    {
+        auto base = search(src);
+        return sorted_keys[base] == static_cast<underlying_type>(src) ? values[base] : fallback;
+    }
+
+    constexpr static std::optional<Dst> find(Src src)
+    {
+        auto base = search(src);
+        if (sorted_keys[base] == static_cast<underlying_type>(src)) {
+            return values[base];
+        }
+        return std::nullopt;
+    }
+};
+
+/**
+ * Perfect hash slots holding each source value and its Dst value, so a lookup
+ * confirms a hit with a single key compare
+ */
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+struct perfect_hash_table
+{
+    using index = perfect_hash_index<MappingTraits, Src>;
+    using keys = typename index::keys;
+    using underlying_type = typename keys::underlying_type;
+
+    struct slot
+    {
+        underlying_type key;
+        Dst value;
+    };
+
+    constexpr static auto slots = [] {
+        std::array<slot, index::size> result {};
+        for (std::size_t i = 0; i < index::size; ++i) {
+            const auto& entry = keys::entries[index::index.slots[i]];
+            result[i] = { entry.key, mapping_column<MappingTraits, Dst>::at(entry.row) };
+        }
+        return result;
+    }();
+
+    constexpr static Dst fallback = fallback_value<MappingTraits, Dst>();
+
+    constexpr static std::size_t footprint = sizeof(slots) + sizeof(index::index.seeds);
+
+    constexpr static const slot& probe(Src src)
+    {
+        auto hash = index::hash_of(static_cast<underlying_type>(src));
+        return slots[index::slot_of(hash, index::index.seeds)];
+    }
+
+    constexpr static Dst lookup(Src src)
+    {
+        const auto& entry = probe(src);
+        return entry.key == static_cast<underlying_type>(src) ? entry.value : fallback;
+    }
+
+    constexpr static std::optional<Dst> find(Src src)
+    {
+        const auto& entry = probe(src);
+        if (entry.key == static_cast<underlying_type>(src)) {
+            return entry.value;
+        }
+        return std::nullopt;
+    }
+};
+
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+struct linear_scan
+{
+    constexpr static std::size_t footprint =
+        sizeof(mapping_column<MappingTraits, Src>::values) + sizeof(mapping_column<MappingTraits, Dst>::values);
+
+    constexpr static std::optional<Dst> find(Src src)
+    {
+        const auto& column = mapping_column<MappingTraits, Src>::values;
+        for (std::size_t row = 0; row < column.size(); ++row) {
+            if (column[row] == static_cast<std::underlying_type_t<Src>>(src)) {
+                return mapping_column<MappingTraits, Dst>::at(row);
+            }
+        }
+        return std::nullopt;
+    }
+
+    constexpr static Dst lookup(Src src)
+    {
+        return find(src).value_or(fallback_value<MappingTraits, Dst>());
+    }
+};
+
+// Backend for Src -> Dst as chosen by select_lookup_strategy, whether or not the pair is functional
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+constexpr auto select_lookup_backend()
+{
+    constexpr auto strategy = select_lookup_strategy<MappingTraits, Src>();
+    if constexpr (strategy == enum_lookup_strategy::dense_table) {
+        return std::type_identity<dense_table<MappingTraits, Src, Dst>> {};
+    } else if constexpr (strategy == enum_lookup_strategy::masked_dense_table) {
+        return std::type_identity<dense_table<MappingTraits, Src, Dst, true>> {};
+    } else if constexpr (strategy == enum_lookup_strategy::perfect_hash) {
+        return std::type_identity<perfect_hash_table<MappingTraits, Src, Dst>> {};
+    } else if constexpr (strategy == enum_lookup_strategy::sorted_array) {
+        return std::type_identity<sorted_array<MappingTraits, Src, Dst>> {};
+    } else {
+        return std::type_identity<linear_scan<MappingTraits, Src, Dst>> {};
+    }
+}
+
+/**
+ * One column of a mapping table indexed by mapping_row, with the fallback value
+ * appended, so that a row lookup is followed by a single load even for
+ * unmapped sources
+ */
+template <typename MappingTraits, EnumConcept Dst>
+struct mapping_row_values
+{
+    constexpr static auto values = [] {
+        std::array<Dst, mapping_rows<MappingTraits> + 1> result {};
+        for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+            result[row] = mapping_column<MappingTraits, Dst>::at(row);
+        }
+        result.back() = fallback_value<MappingTraits, Dst>();
+        return result;
+    }();
+};
+
+template <typename MappingType>
+struct enum_columns;
+
+template <typename... Types>
+struct enum_columns<std::tuple<Types...>>
+{
+    constexpr static std::size_t count = (std::size_t(0) + ... + std::size_t(EnumConcept<Types>));
+
+    // Whether Pred<A, B>() holds for every ordered pair of distinct enum columns
+    template <template <typename, typename> typename Pred>
+    constexpr static bool all_pairs = [] {
+        bool result = true;
+        auto from = [&]<typename A>(std::type_identity<A>) {
+            auto to = [&]<typename B>(std::type_identity<B>) {
+                if constexpr (EnumConcept<A> && EnumConcept<B> && !std::is_same_v<A, B>) {
+                    result = result && Pred<A, B>::value;
+                }
+            };
+            (to(std::type_identity<Types> {}), ...);
+        };
+        (from(std::type_identity<Types> {}), ...);
+        return result;
+    }();
+};
+
+template <typename MappingTraits>
+struct functional_pair
+{
+    template <typename Src, typename Dst>
+    using test = std::bool_constant<is_functional<MappingTraits, Src, Dst>()>;
+};
+
+// Below this many enum columns, direct per-pair tables take less memory than shared row indexes
+inline constexpr std::size_t shared_row_index_min_columns = 3;
+
+/**
+ * Whether enum_cast serves the category through one Src -> mapping_row index
+ * per enum column instead of one table per ordered pair: the category's
+ * `shared_row_index` when it declares one, otherwise whenever every pair of
+ * enum columns is bijective and there are enough columns for the indexes to be
+ * the smaller layout.
+ *
+ * In a bijective category each column is a permutation of the row indexes and
+ * its index is that permutation's inverse, so the N indexes and N columns
+ * replace the N * (N - 1) pair tables, and a lookup stays two loads.
+ */
+template <typename MappingTraits>
+consteval bool shares_row_index()
+{
+    using columns = enum_columns<typename MappingTraits::mapping_type>;
+    constexpr bool bijective = columns::template all_pairs<functional_pair<MappingTraits>::template test>;
+    if constexpr (requires { { MappingTraits::shared_row_index } -> std::convertible_to<bool>; }) {
+        static_assert(!MappingTraits::shared_row_index || bijective,
+                      "shared_row_index requires every pair of enum columns to be bijective");
+        return MappingTraits::shared_row_index;
+    } else {
+        return bijective && columns::count >= shared_row_index_min_columns && mapping_rows<MappingTraits> != 0;
+    }
+}
+
+// Src -> Dst through the Src column's row index and the Dst column, see shares_row_index
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+struct row_indexed_table
+{
+    using index = typename decltype(select_lookup_backend<MappingTraits, Src, mapping_row>())::type;
+
+    constexpr static std::size_t footprint = index::footprint + sizeof(mapping_row_values<MappingTraits, Dst>::values);
+
+    constexpr static Dst lookup(Src src)
+    {
+        return mapping_row_values<MappingTraits, Dst>::values[static_cast<std::size_t>(index::lookup(src))];
+    }
+
+    constexpr static std::optional<Dst> find(Src src)
+    {
+        if (auto row = index::find(src)) {
+            return mapping_row_values<MappingTraits, Dst>::values[static_cast<std::size_t>(*row)];
+        }
+        return std::nullopt;
+    }
+};
+
+// Backend serving Src -> Dst lookups
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+constexpr auto select_lookup_table()
+{
+    // Row lookups differ between duplicate rows by design and always yield the first one
+    static_assert(std::is_same_v<Dst, mapping_row> || allows_duplicate_keys<MappingTraits>() ||
+                      is_functional<MappingTraits, Src, Dst>(),
+                  "A source enum value maps to different destination values in different rows; remove the "
+                  "conflicting row or declare allow_duplicate_keys to keep first-match semantics");
+    if constexpr (!std::is_same_v<Dst, mapping_row> && shares_row_index<MappingTraits>()) {
+        return std::type_identity<row_indexed_table<MappingTraits, Src, Dst>> {};
+    } else {
+        return select_lookup_backend<MappingTraits, Src, Dst>();
+    }
+}
+
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+using lookup_table_t = typename decltype(select_lookup_table<MappingTraits, Src, Dst>())::type;
+
+// Whether a backend goes through a shared row index, whose own strategy is that of the Src column
+template <typename Table>
+inline constexpr bool is_row_indexed_table = false;
+
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+inline constexpr bool is_row_indexed_table<row_indexed_table<MappingTraits, Src, Dst>> = true;
+
+// The mapping rows followed by the category's default_mapping, or a value-initialized row
+template <typename MappingTraits>
+struct mapping_row_tuples
+{
+    using mapping_type = typename MappingTraits::mapping_type;
+
+    constexpr static mapping_type fallback = [] {
+        if constexpr (requires { { MappingTraits::default_mapping } -> std::convertible_to<mapping_type>; }) {
+            return mapping_type(MappingTraits::default_mapping);
+        } else {
+            return mapping_type {};
+        }
+    }();
+
+    // Built in one piece: assigning tuples into a value-initialized array trips up some constant evaluators
+    constexpr static auto values = []<std::size_t... Rows>(std::index_sequence<Rows...>) {
+        return std::array<mapping_type, sizeof...(Rows) + 1> { mapping_type(std::ranges::begin(MappingTraits::mappings)[Rows])...,
+                                                               fallback };
+    }(std::make_index_sequence<mapping_rows<MappingTraits>> {});
+};
+
+// Whether the first row holding each Src value can stand for all of them as far as every Dst is concerned
+template <typename MappingTraits, EnumConcept Src, typename... Dsts>
+consteval bool first_row_agrees()
+{
+    return allows_duplicate_keys<MappingTraits>() || (true && ... && is_functional<MappingTraits, Src, Dsts>());
+}
+
+template <typename MappingTraits, EnumConcept Src, typename MappingType>
+struct row_agrees;
+
+template <typename MappingTraits, EnumConcept Src, typename... Types>
+struct row_agrees<MappingTraits, Src, std::tuple<Types...>>
+{
+    template <typename Type>
+    constexpr static bool column_agrees()
+    {
+        if constexpr (EnumConcept<Type>) {
+            return first_row_agrees<MappingTraits, Src, Type>();
+        } else {
+            return true;
+        }
+    }
+
+    constexpr static bool value = (true && ... && column_agrees<Types>());
+};
+
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+constexpr std::size_t table_footprint()
+{
+    if constexpr (shares_row_index<MappingTraits>()) {
+        return row_indexed_table<MappingTraits, Src, Dst>::footprint;
+    } else {
+        return decltype(select_lookup_backend<MappingTraits, Src, Dst>())::type::footprint;
+    }
+}
+
+// Footprint of the tables between every ordered pair of distinct enum columns, shared row indexes counted once
+template <typename MappingTraits, typename... Types>
+constexpr std::size_t category_footprint(std::type_identity<std::tuple<Types...>>)
+{
+    std::size_t total = 0;
+    if constexpr (shares_row_index<MappingTraits>()) {
+        auto add = [&]<typename Enum>(std::type_identity<Enum>) {
+            if constexpr (EnumConcept<Enum>) {
+                total += row_indexed_table<MappingTraits, Enum, Enum>::footprint;
+            }
+        };
+        (add(std::type_identity<Types> {}), ...);
+        return total;
+    }
+    auto add_from = [&]<typename Src>(std::type_identity<Src>) {
+        auto add_to = [&]<typename Dst>(std::type_identity<Dst>) {
+            if constexpr (EnumConcept<Src> && EnumConcept<Dst> && !std::is_same_v<Src, Dst>) {
+                total += table_footprint<MappingTraits, Src, Dst>();
+            }
+        };
+        (add_to(std::type_identity<Types> {}), ...);
+    };
+    (add_from(std::type_identity<Types> {}), ...);
+    return total;
+}
+
+} // namespace enum_cast_detail
+
+/*
+ * Compile-time properties of a category's mapping table, validated over the
+ * whole table and usable in static_assert or to pick a code path
+ */
+
+// Number of rows whose Enum value already occurs in an earlier row
+template <typename Category, EnumConcept Enum>
+inline constexpr std::size_t enum_mapping_duplicate_keys_v =
+    enum_cast_detail::source_keys<enum_mapping_traits<Category>, Enum>::duplicates;
+
+// Whether each Src value in the table corresponds to a single Dst value
+template <typename Category, EnumConcept Src, EnumConcept Dst>
+inline constexpr bool enum_mapping_functional_v =
+    enum_cast_detail::is_functional<enum_mapping_traits<Category>, Src, Dst>();
+
+// Whether the table pairs the listed A and B values one-to-one
+template <typename Category, EnumConcept A, EnumConcept B>
+inline constexpr bool enum_mapping_bijective_v =
+    enum_mapping_functional_v<Category, A, B> && enum_mapping_functional_v<Category, B, A>;
+
+/**
+ * Whether enum_cast<A>(enum_cast<B>(a)) == a for every A value of the table,
+ * and the same from B; false when A and B are of different categories
+ *
+ * Holds for bijective pairs, and is checked by evaluating both conversions
+ * over the whole table.
+ */
+template <EnumConcept A, EnumConcept B>
+struct enum_round_trips : std::false_type {};
+
+template <EnumConcept A, EnumConcept B>
+    requires std::is_same_v<enum_category_t<A>, enum_category_t<B>>
+struct enum_round_trips<A, B> : std::bool_constant<[] {
+    using MappingTraits = enum_mapping_traits<enum_category_t<A>>;
+    if constexpr (std::is_same_v<A, B>) {
+        return true;
+    } else if constexpr (!enum_cast_detail::is_functional<MappingTraits, A, B>() ||
+                         !enum_cast_detail::is_functional<MappingTraits, B, A>()) {
+        return false;
+    } else {
+        using a_to_b = enum_cast_detail::lookup_table_t<MappingTraits, A, B>;
+        using b_to_a = enum_cast_detail::lookup_table_t<MappingTraits, B, A>;
+        for (std::size_t row = 0; row < enum_cast_detail::mapping_rows<MappingTraits>; ++row) {
+            A a = enum_cast_detail::mapping_column<MappingTraits, A>::at(row);
+            B b = enum_cast_detail::mapping_column<MappingTraits, B>::at(row);
+            if (b_to_a::lookup(a_to_b::lookup(a)) != a || a_to_b::lookup(b_to_a::lookup(b)) != b) {
+                return false;
+            }
+        }
+        return true;
+    }
+}()> {};
+
+template <EnumConcept A, EnumConcept B>
+inline constexpr bool enum_round_trips_v = enum_round_trips<A, B>::value;
+
+// Bytes of the arrays an enum_cast<Dst>(Src) lookup reads, whichever backend serves it
+template <typename Category, EnumConcept Src, EnumConcept Dst>
+inline constexpr std::size_t enum_mapping_table_bytes_v =
+    enum_cast_detail::table_footprint<enum_mapping_traits<Category>, Src, Dst>();
+
+// Sum of enum_mapping_table_bytes_v over every ordered pair of enum columns in the category
+template <typename Category>
+inline constexpr std::size_t enum_mapping_footprint_v = enum_cast_detail::category_footprint<enum_mapping_traits<Category>>(
+    std::type_identity<typename enum_mapping_traits<Category>::mapping_type> {});
+
+namespace enum_cast_detail {
+
+// Defaults for members a specialization of enum_reflection_range leaves out
+inline constexpr std::int64_t enum_reflection_default_min = -128;
+inline constexpr std::int64_t enum_reflection_default_max = 127;
+
+} // namespace enum_cast_detail
+
+/**
+ * Value range scanned for enumerator names by enum_mappings_by_name
+ *
+ * Specialize it for an enum whose values lie outside the default range, or to
+ * shorten the scan; members left out keep their defaults. With `flags` set,
+ * zero and each single bit of the underlying type are scanned instead.
+ *
+ * @note Every scanned value is one template instantiation, so the range bounds
+ *       the compile time spent per enum
+ */
+template <EnumConcept Enum>
+struct enum_reflection_range
+{
+    constexpr static std::int64_t min = enum_cast_detail::enum_reflection_default_min;
+    constexpr static std::int64_t max = enum_cast_detail::enum_reflection_default_max;
+    constexpr static bool flags = false;
+};
+
+// Default name normalizer for enum_mappings_by_name: ASCII case folding, so READ matches Read
+struct enum_name_fold_case
+{
+    constexpr std::string operator()(std::string_view name) const
+    {
+        std::string result(name);
+        for (char& c : result) {
+            c = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+        return result;
+    }
+};
+
+namespace enum_cast_detail {
+
+inline constexpr std::size_t enum_reflection_max_values = 1 << 16;
+
+template <auto Value>
+constexpr auto enumerator_signature()
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return std::string_view(__PRETTY_FUNCTION__);
+#elif defined(_MSC_VER)
+    return std::string_view(__FUNCSIG__);
+#else
+    return std::string_view();
+#endif
+}
+
+/*
+ * Name of the enumerator with value Value, as spelled by the compiler in the
+ * signature of enumerator_signature<Value>: "... [with auto Value = ns::E::Name]"
+ * on GCC and Clang, "...<ns::E::Name>(void)" on MSVC. Values without an
+ * enumerator show up as a cast such as "(ns::E)7" and yield an empty view.
+ */
+template <auto Value>
+constexpr std::string_view enumerator_name()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    constexpr std::string_view suffix = ">(void)";
+#else
+    constexpr std::string_view suffix = "]";
+#endif
+    std::string_view signature = enumerator_signature<Value>();
+    if (!signature.ends_with(suffix)) {
+        return {};
+    }
+    signature.remove_suffix(suffix.size());
+    auto identifier = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    };
+    std::size_t start = signature.size();
+    while (start > 0 && identifier(signature[start - 1])) {
+        --start;
+    }
+    std::string_view name = signature.substr(start);
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9')) {
+        return {};
+    }
+    return name;
+}
+
+// Enumerators of Enum found within its enum_reflection_range, in ascending value order
+template <EnumConcept Enum>
+struct reflected_enumerators
+{
+    using underlying_type = std::underlying_type_t<Enum>;
+    using range = enum_reflection_range<Enum>;
+
+    constexpr static bool flags = [] {
+        if constexpr (requires { { range::flags } -> std::convertible_to<bool>; }) {
+            return static_cast<bool>(range::flags);
+        } else {
+            return false;
+        }
+    }();
+
+    // Requested bounds clamped to the values the underlying type can hold
+    constexpr static std::int64_t min = [] {
+        std::int64_t requested = enum_reflection_default_min;
+        if constexpr (requires { { range::min } -> std::convertible_to<std::int64_t>; }) {
+            requested = range::min;
+        }
+        return std::cmp_less(requested, std::numeric_limits<underlying_type>::min())
+                   ? static_cast<std::int64_t>(std::numeric_limits<underlying_type>::min())
+                   : requested;
+    }();
+    constexpr static std::int64_t max = [] {
+        std::int64_t requested = enum_reflection_default_max;
+        if constexpr (requires { { range::max } -> std::convertible_to<std::int64_t>; }) {
+            requested = range::max;
+        }
+        return std::cmp_greater(requested, std::numeric_limits<underlying_type>::max())
+                   ? static_cast<std::int64_t>(std::numeric_limits<underlying_type>::max())
+                   : requested;
+    }();
+
+    constexpr static std::size_t scanned =
+        flags ? std::numeric_limits<std::make_unsigned_t<underlying_type>>::digits + 1
+              : (min <= max ? static_cast<std::size_t>(max - min) + 1 : 0);
+    static_assert(scanned <= enum_reflection_max_values,
+                  "The enum_reflection_range of this enum is too wide to scan; narrow it or list the mappings");
+
+    constexpr static underlying_type candidate(std::size_t index)
+    {
+        if constexpr (flags) {
+            using unsigned_type = std::make_unsigned_t<underlying_type>;
+            return index == 0 ? underlying_type(0) : static_cast<underlying_type>(unsigned_type(1) << (index - 1));
+        } else {
+            return static_cast<underlying_type>(min + static_cast<std::int64_t>(index));
+        }
+    }
+
+    constexpr static auto scan = []<std::size_t... Index>(std::index_sequence<Index...>) {
+        return std::array<std::string_view, scanned> { enumerator_name<static_cast<Enum>(candidate(Index))>()... };
+    }(std::make_index_sequence<scanned> {});
+
+    constexpr static std::size_t count = std::ranges::count_if(scan, [](std::string_view name) { return !name.empty(); });
+
+    constexpr static auto values = [] {
+        std::array<Enum, count> result {};
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < scanned; ++i) {
+            if (!scan[i].empty()) {
+                result[found++] = static_cast<Enum>(candidate(i));
+            }
+        }
+        return result;
+    }();
+
+    constexpr static auto names = [] {
+        std::array<std::string_view, count> result {};
+        std::ranges::copy_if(scan, result.begin(), [](std::string_view name) { return !name.empty(); });
+        return result;
+    }();
+};
+
+template <typename MappingType, typename Normalizer>
+struct name_matched_mappings;
+
+/*
+ * One row per enumerator of First whose normalized name every enum in Rest
+ * also holds; the first such enumerator of each Rest enum is taken.
+ */
+template <EnumConcept First, EnumConcept... Rest, typename Normalizer>
+struct name_matched_mappings<std::tuple<First, Rest...>, Normalizer>
+{
+    constexpr static std::size_t npos = static_cast<std::size_t>(-1);
+
+    template <EnumConcept Enum>
+    constexpr static std::size_t index_of(const auto& normalized)
+    {
+        for (std::size_t i = 0; i < reflected_enumerators<Enum>::count; ++i) {
+            if (Normalizer {}(reflected_enumerators<Enum>::names[i]) == normalized) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    constexpr static bool matched(std::size_t first)
+    {
+        auto normalized = Normalizer {}(reflected_enumerators<First>::names[first]);
+        return ((index_of<Rest>(normalized) != npos) && ...);
+    }
+
+    constexpr static std::size_t count = [] {
+        std::size_t rows = 0;
+        for (std::size_t i = 0; i < reflected_enumerators<First>::count; ++i) {
+            rows += matched(i);
+        }
+        return rows;
+    }();
+
+    constexpr static auto mappings = [] {
+        std::array<std::tuple<First, Rest...>, count> result {};
+        std::size_t row = 0;
+        for (std::size_t i = 0; i < reflected_enumerators<First>::count; ++i) {
+            if (matched(i)) {
+                auto normalized = Normalizer {}(reflected_enumerators<First>::names[i]);
+                result[row++] = { reflected_enumerators<First>::values[i],
+                                  reflected_enumerators<Rest>::values[index_of<Rest>(normalized)]... };
+            }
+        }
+        return result;
+    }();
+};
+
+} // namespace enum_cast_detail
+
+/**
+ * Mapping rows derived from enumerator names, for use as a category's `mappings`
+ *
+ * @tparam MappingType The category's std::tuple of enum types; rows follow the
+ *         value order of the first one
+ * @tparam Normalizer Default-constructible callable turning an enumerator name
+ *         into the form that is compared, e.g. by folding case or dropping a prefix
+ * @return A std::array with one row per enumerator of the first enum whose
+ *         normalized name occurs in every other enum
+ *
+ * @note Names are read from the compiler's function signatures, scanning the
+ *       values in each enum's enum_reflection_range; enumerators outside it are
+ *       not found, and of several enumerators sharing a value only one is seen
+ * @note For unscoped enums without a fixed underlying type, keep the range
+ *       within the enum's declared values; some compilers reject out-of-range
+ *       casts in constant expressions
+ */
+template <typename MappingType, typename Normalizer = enum_name_fold_case>
+consteval auto enum_mappings_by_name()
+{
+    return enum_cast_detail::name_matched_mappings<MappingType, Normalizer>::mappings;
+}
+
+namespace enum_cast_detail {
+
+template <typename MappingTraits>
+concept instrumented = requires { typename MappingTraits::instrumentation; };
+
+// Reports a run-time conversion to the category's instrumentation policy
+template <typename Category, EnumConcept Src, EnumConcept Dst>
+void record_conversion(enum_cast_operation operation, bool missed)
+{
+    enum_mapping_traits<Category>::instrumentation::template record<Category, Src, Dst>(operation, missed);
+}
+
+} // namespace enum_cast_detail
+
+/**
+ * Converts an enum value from one type to another within the same category
+ * 
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum value to convert
+ * @return The equivalent enum value in the destination type
+ * 
+ * @note Source and destination enums must belong to the same category
+ * @note Returns the category's default_mapping entry for Dst if no mapping is
+ *       found, or the enum value 0 when the category declares none
+ * @note The lookup strategy is fixed per source column at compile time, see
+ *       enum_lookup_strategy and enum_cast_detail::select_lookup_strategy
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr Dst enum_cast(Src src)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    using Category = enum_category_t<Src>;
+    using MappingTraits = enum_mapping_traits<Category>;
+    using Table = enum_cast_detail::lookup_table_t<MappingTraits, Src, Dst>;
+    if constexpr (enum_cast_detail::instrumented<MappingTraits>) {
+        if (!std::is_constant_evaluated()) {
+            auto dst = Table::find(src);
+            enum_cast_detail::record_conversion<Category, Src, Dst>(enum_cast_operation::enum_cast, !dst);
+            return dst ? *dst : enum_cast_detail::fallback_value<MappingTraits, Dst>();
+        }
+    }
+    return Table::lookup(src);
+}
+
+/**
+ * Converts an enum value from one type to another within the same category,
+ * reporting a missing mapping instead of substituting a fallback value
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum value to convert
+ * @return The equivalent enum value in the destination type, or std::nullopt
+ *         if the source value has no mapping
+ *
+ * @note Uses the same single lookup as enum_cast
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr std::optional<Dst> try_enum_cast(Src src)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    using Category = enum_category_t<Src>;
+    using MappingTraits = enum_mapping_traits<Category>;
+    auto dst = enum_cast_detail::lookup_table_t<MappingTraits, Src, Dst>::find(src);
+    if constexpr (enum_cast_detail::instrumented<MappingTraits>) {
+        if (!std::is_constant_evaluated()) {
+            enum_cast_detail::record_conversion<Category, Src, Dst>(enum_cast_operation::enum_cast, !dst);
+        }
+    }
+    return dst;
+}
+
+#if defined(__cpp_lib_expected)
+/**
+ * Same as try_enum_cast, reporting a missing mapping as std::unexpected(unmapped)
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr std::expected<Dst, unmapped_t> expected_enum_cast(Src src)
+{
+    if (auto dst = try_enum_cast<Dst>(src)) {
+        return *dst;
+    }
+    return std::unexpected(unmapped);
+}
+#endif
+
+namespace enum_cast_detail {
+
+template <typename MappingType, typename Enum>
+inline constexpr bool holds_column = false;
+
+template <typename... Types, typename Enum>
+inline constexpr bool holds_column<std::tuple<Types...>, Enum> = (false || ... || std::is_same_v<Types, Enum>);
+
+/**
+ * Mapping traits of the two-hop conversion Src -> Mid -> Dst, where Src and Mid
+ * share the category of Src and Mid and Dst share the category of Dst
+ *
+ * There is one row per distinct Src value, holding the Dst value that the two
+ * lookups yield, so that enum_cast's backends serve the composition directly.
+ * Strict keeps only the rows where both hops find a mapping.
+ */
+template <EnumConcept Src, EnumConcept Mid, EnumConcept Dst, bool Strict>
+struct composed_mapping_traits
+{
+    using first_traits = enum_mapping_traits<enum_category_t<Src>>;
+    using second_traits = enum_mapping_traits<enum_category_t<Dst>>;
+
+    static_assert(holds_column<typename first_traits::mapping_type, Mid>,
+                  "The intermediate enum must be a column of the source enum's category");
+    static_assert(holds_column<typename second_traits::mapping_type, Mid>,
+                  "The intermediate enum must be a column of the destination enum's category");
+    static_assert(!std::is_same_v<Src, Dst>, "A composed conversion must change the enum type");
+
+    using first = lookup_table_t<first_traits, Src, Mid>;
+    using second = lookup_table_t<second_traits, Mid, Dst>;
+    using keys = source_keys<first_traits, Src>;
+    using mapping_type = std::tuple<Src, Dst>;
+
+    constexpr static bool composes(std::size_t key)
+    {
+        if constexpr (Strict) {
+            auto mid = first::find(static_cast<Src>(keys::entries[key].key));
+            return mid && second::find(*mid);
+        } else {
+            return true;
+        }
+    }
+
+    constexpr static std::size_t rows = [] {
+        std::size_t count = 0;
+        for (std::size_t key = 0; key < keys::size; ++key) {
+            count += composes(key);
+        }
+        return count;
+    }();
+
+    constexpr static auto mappings = [] {
+        std::array<mapping_type, rows> result {};
+        std::size_t row = 0;
+        for (std::size_t key = 0; key < keys::size; ++key) {
+            if (composes(key)) {
+                auto src = static_cast<Src>(keys::entries[key].key);
+                result[row++] = { src, second::lookup(first::lookup(src)) };
+            }
+        }
+        return result;
+    }();
+
+    // What the second hop makes of the first hop's fallback
+    constexpr static mapping_type default_mapping = { Src {}, second::lookup(fallback_value<first_traits, Mid>()) };
+
+    // Rows are built in ascending Src order
+    constexpr static auto sorted_rows(std::type_identity<Src>)
+    {
+        std::array<std::size_t, rows> order {};
+        for (std::size_t row = 0; row < rows; ++row) {
+            order[row] = row;
+        }
+        return order;
+    }
+};
+
+} // namespace enum_cast_detail
+
+/**
+ * Converts an enum value through an intermediate enum shared with another
+ * category, with a single lookup
+ *
+ * @tparam Mid The intermediate enum type, a column of both categories
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum value to convert
+ * @return enum_cast<Dst>(enum_cast<Mid>(src)), fallback values included
+ *
+ * @note Src and Mid are mapped by the category of Src, Mid and Dst by the
+ *       category of Dst; the two mappings are folded at compile time into one
+ *       Src -> Dst table with its own backend
+ */
+template <EnumConcept Mid, EnumConcept Dst, EnumConcept Src>
+constexpr Dst enum_cast_via(Src src)
+{
+    using MappingTraits = enum_cast_detail::composed_mapping_traits<Src, Mid, Dst, false>;
+    return enum_cast_detail::lookup_table_t<MappingTraits, Src, Dst>::lookup(src);
+}
+
+/**
+ * Converts an enum value through an intermediate enum like enum_cast_via
+ *
+ * @return The converted value, or std::nullopt when either hop has no mapping
+ */
+template <EnumConcept Mid, EnumConcept Dst, EnumConcept Src>
+constexpr std::optional<Dst> try_enum_cast_via(Src src)
+{
+    using MappingTraits = enum_cast_detail::composed_mapping_traits<Src, Mid, Dst, true>;
+    return enum_cast_detail::lookup_table_t<MappingTraits, Src, Dst>::find(src);
+}
+
+/**
+ * Converts an enum value into every enum of its category at once
+ *
+ * @tparam Src The source enum type
+ * @param src The source enum value to convert
+ * @return The first mapping row holding src, or the category's default_mapping
+ *         row (value-initialized when it declares none) if no row does
+ *
+ * @note One lookup finds the row index, shared by every column of the row; the
+ *       result refers to the category's static row storage
+ */
+template <EnumConcept Src>
+constexpr const typename enum_mapping_traits<enum_category_t<Src>>::mapping_type& enum_cast_all(Src src)
+{
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    static_assert(enum_cast_detail::row_agrees<MappingTraits, Src, typename MappingTraits::mapping_type>::value,
+                  "A source enum value maps to different destination values in different rows; remove the "
+                  "conflicting row or declare allow_duplicate_keys to keep first-match semantics");
+    using table = enum_cast_detail::lookup_table_t<MappingTraits, Src, enum_cast_detail::mapping_row>;
+    return enum_cast_detail::mapping_row_tuples<MappingTraits>::values[static_cast<std::size_t>(table::lookup(src))];
+}
+
+/**
+ * Converts an enum value into several enums of its category at once
+ *
+ * @tparam Dsts The destination enum types
+ * @tparam Src The source enum type
+ * @param src The source enum value to convert
+ * @return The values enum_cast<Dsts>(src) would return, in order
+ *
+ * @note One lookup finds the row index, then each destination is a single load
+ */
+template <EnumConcept... Dsts, EnumConcept Src>
+    requires(sizeof...(Dsts) > 0)
+constexpr std::tuple<Dsts...> enum_cast_all(Src src)
+{
+    static_assert((std::is_same_v<enum_category_t<Src>, enum_category_t<Dsts>> && ...),
+                 "Source and destination enums must be of the same category");
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    static_assert(enum_cast_detail::first_row_agrees<MappingTraits, Src, Dsts...>(),
+                  "A source enum value maps to different destination values in different rows; remove the "
+                  "conflicting row or declare allow_duplicate_keys to keep first-match semantics");
+    using table = enum_cast_detail::lookup_table_t<MappingTraits, Src, enum_cast_detail::mapping_row>;
+    const auto row = static_cast<std::size_t>(table::lookup(src));
+    return { enum_cast_detail::mapping_row_values<MappingTraits, Dsts>::values[row]... };
+}
+
+/**
+ * Converts a contiguous run of enum values from one type to another within the
+ * same category
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum values to convert
+ * @param dst Receives the converted values; must hold at least src.size() elements
+ *
+ * @note Each element converts exactly as enum_cast would
+ * @note Dense tables of 32-bit enums are converted with AVX2 gathers, or with
+ *       SSSE3/AVX2 byte shuffles when the table fits in 16 bytes
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr void enum_cast_n(std::span<const Src> src, std::span<Dst> dst)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    assert(dst.size() >= src.size());
+    std::size_t done = 0;
+#if defined(__SSSE3__) || defined(__AVX2__)
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    constexpr auto strategy = enum_cast_detail::select_lookup_strategy<MappingTraits, Src>();
+    // Instrumented categories convert element by element, so that every conversion is recorded
+    if constexpr ((strategy == enum_lookup_strategy::dense_table || strategy == enum_lookup_strategy::masked_dense_table)
+                  && sizeof(Src) == 4 && sizeof(Dst) == 4 && !enum_cast_detail::instrumented<MappingTraits>) {
+        if (!std::is_constant_evaluated()) {
+            // The direct table even in categories with shared row indexes, as the gathers need one load per lane
+            using Table = typename decltype(enum_cast_detail::select_lookup_backend<MappingTraits, Src, Dst>())::type;
+            done = enum_cast_detail::dense_table_batch_simd<Table>(src.data(), dst.data(), src.size());
+        }
+    }
+#endif
+    for (; done < src.size(); ++done) {
+        dst[done] = enum_cast<Dst>(src[done]);
+    }
+}
+
+// Takes a mutable source span, as std::span(values) deduces for a non-const container
+template <EnumConcept Dst, EnumConcept Src>
+    requires(!std::is_const_v<Src>)
+constexpr void enum_cast_n(std::span<Src> src, std::span<Dst> dst)
+{
+    enum_cast_n<Dst>(std::span<const Src>(src), dst);
+}
+
+namespace views {
+
+/**
+ * Range adaptor applying enum_cast<Dst> to each element, e.g.
+ * `records | views::enum_cast<lib_a::Color>`
+ */
+template <EnumConcept Dst>
+inline constexpr auto enum_cast = std::views::transform([]<EnumConcept Src>(Src src) { return ::enum_cast<Dst>(src); });
+
+} // namespace views
+
+namespace enum_cast_detail {
+
+// Above this many names a sorted array replaces the compile-time hash search, as for enum columns
+inline constexpr std::size_t name_hash_max_names = perfect_hash_max_rows;
+
+template <typename MappingType>
+inline constexpr std::size_t name_columns = 0;
+
+template <typename... Types>
+inline constexpr std::size_t name_columns<std::tuple<Types...>> = (std::size_t(0) + ... + std::size_t(std::is_same_v<Types, std::string_view>));
+
+/*
+ * A category carries names when its mapping_type holds one std::string_view
+ * column, e.g. std::tuple<lib_a::Color, lib_b::Color, std::string_view>; every
+ * enum of the category then shares the row's name.
+ */
+template <typename MappingTraits>
+concept NamedMappingTraitsConcept = name_columns<typename MappingTraits::mapping_type> == 1;
+
+/**
+ * Names by row, with the `default_mapping` name (or an empty view) one past
+ * the last row, where row lookups put unmapped values
+ */
+template <typename MappingTraits>
+struct mapping_names
+{
+    constexpr static auto values = [] {
+        std::array<std::string_view, mapping_rows<MappingTraits> + 1> result {};
+        std::size_t row = 0;
+        for (const auto& mapping : MappingTraits::mappings) {
+            result[row++] = std::get<std::string_view>(mapping);
+        }
+        if constexpr (requires { { MappingTraits::default_mapping } -> std::convertible_to<typename MappingTraits::mapping_type>; }) {
+            result[row] = std::get<std::string_view>(MappingTraits::default_mapping);
+        }
+        return result;
+    }();
+};
+
+// Little-endian load of Bytes bytes starting at offset, the same at compile time and at run time
+template <std::size_t Bytes>
+constexpr std::uint64_t load_name_bytes(std::string_view name, std::size_t offset)
+{
+    if (!std::is_constant_evaluated() && std::endian::native == std::endian::little) {
+        std::conditional_t<Bytes == 8, std::uint64_t, std::uint32_t> word;
+        std::memcpy(&word, name.data() + offset, Bytes);
+        return word;
+    }
+    std::uint64_t word = 0;
+    for (std::size_t i = 0; i < Bytes; ++i) {
+        word |= static_cast<std::uint64_t>(static_cast<unsigned char>(name[offset + i])) << (8 * i);
+    }
+    return word;
+}
+
+// The first 16 bytes of a name as two little-endian words, zero-padded past its end
+struct name_words
+{
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+};
+
+/*
+ * Words of a name of at most 16 bytes from fixed-size loads: overlapping words
+ * shifted into place, with byte loads only below four bytes
+ */
+constexpr name_words short_name_words(std::string_view name)
+{
+    const std::size_t size = name.size();
+    name_words words;
+    if (size >= 8) {
+        words.low = load_name_bytes<8>(name, 0);
+        words.high = (load_name_bytes<8>(name, size - 8) >> (8 * (16 - size) & 63)) &
+                     (0 - static_cast<std::uint64_t>(size > 8));
+    } else if (size >= 4) {
+        words.low = load_name_bytes<4>(name, 0) | load_name_bytes<4>(name, size - 4) >> (8 * (8 - size)) << 32;
+    } else {
+        for (std::size_t i = 0; i < size; ++i) {
+            words.low |= static_cast<std::uint64_t>(static_cast<unsigned char>(name[i])) << (8 * i);
+        }
+    }
+    return words;
+}
+
+/*
+ * As short_name_words, for a name followed by at least 16 - name.size() more
+ * readable bytes, such as a field inside a larger buffer: two whole-word loads
+ * and two masks, without a branch on the length
+ */
+inline name_words padded_name_words(std::string_view name)
+{
+    auto mask = [](std::size_t bytes) { return bytes >= 8 ? ~std::uint64_t(0) : (std::uint64_t(1) << (8 * bytes)) - 1; };
+    const std::size_t size = name.size();
+    name_words words;
+    std::memcpy(&words.low, name.data(), 8);
+    std::memcpy(&words.high, name.data() + 8, 8);
+    words.low &= mask(size);
+    words.high &= mask(size > 8 ? size - 8 : 0);
+    return words;
+}
+
+// Words of any name; longer names keep their first 16 bytes
+constexpr name_words words_of_name(std::string_view name)
+{
+    if (name.size() <= 16) {
+        return short_name_words(name);
+    }
+    return { load_name_bytes<8>(name, 0), load_name_bytes<8>(name, 8) };
+}
+
+/*
+ * Hashes every byte of the name: the words of a name of at most 16 bytes,
+ * longer names 16 bytes at a time with the last block overlapping the previous
+ */
+constexpr std::uint64_t hash_name(std::string_view name, name_words words)
+{
+    const std::size_t size = name.size();
+    std::uint64_t hash = (size + 1) * 0x9e3779b97f4a7c15ull;
+    if (size > 16) {
+        for (std::size_t offset = 0; offset + 16 < size; offset += 16) {
+            hash = mix64(mix64(hash ^ load_name_bytes<8>(name, offset)) ^ load_name_bytes<8>(name, offset + 8));
+        }
+        words = { load_name_bytes<8>(name, size - 16), load_name_bytes<8>(name, size - 8) };
+    }
+    return mix64(mix64(hash ^ words.low) ^ words.high);
+}
+
+constexpr std::uint64_t hash_name(std::string_view name)
+{
+    return hash_name(name, words_of_name(name));
+}
+
+// Name equality for names longer than 16 bytes, compared 16 bytes at a time with SSE2
+constexpr bool equal_names(std::string_view a, std::string_view b)
+{
+    if (std::is_constant_evaluated()) {
+        return a == b;
+    }
+    const std::size_t size = a.size();
+    if (size != b.size()) {
+        return false;
+    }
+#if defined(__SSE2__) || defined(_M_X64)
+    if (size >= 16) {
+        auto differs = [&](std::size_t offset) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + offset));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + offset));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff;
+        };
+        for (std::size_t offset = 0; offset + 16 < size; offset += 16) {
+            if (differs(offset)) {
+                return false;
+            }
+        }
+        return !differs(size - 16);
+    }
+#endif
+    return a == b;
+}
+
+/**
+ * Distinct names of a category, each paired with the first row it occurs in,
+ * and a perfect hash over them
+ *
+ * Repeated names are found with a compile-time hash set rather than by sorting,
+ * which keeps string compares to the rare equal hashes. Names are only sorted
+ * when the list is too long to hash or no perfect hash was found.
+ */
+template <typename MappingTraits>
+struct name_keys
+{
+    struct entry
+    {
+        std::uint64_t hash;
+        std::size_t row;
+        std::string_view name;
+    };
+
+    constexpr static std::size_t rows = mapping_rows<MappingTraits>;
+
+    constexpr static auto row_hashes = [] {
+        std::array<std::uint64_t, rows> result {};
+        for (std::size_t row = 0; row < rows; ++row) {
+            result[row] = hash_name(mapping_names<MappingTraits>::values[row]);
+        }
+        return result;
+    }();
+
+    // Whether each row is the first to hold its name
+    constexpr static auto first_rows = [] {
+        std::array<bool, rows> result {};
+        constexpr std::size_t capacity = std::bit_ceil(2 * rows + 1);
+        std::array<std::size_t, capacity> set {};  // row + 1, or 0 for a free slot
+        for (std::size_t row = 0; row < rows; ++row) {
+            const auto& names = mapping_names<MappingTraits>::values;
+            std::size_t i = row_hashes[row] & (capacity - 1);
+            bool repeated = false;
+            for (; set[i] != 0 && !repeated; i = (i + 1) & (capacity - 1)) {
+                repeated = row_hashes[set[i] - 1] == row_hashes[row] && names[set[i] - 1] == names[row];
+            }
+            if (!repeated) {
+                set[i] = row + 1;
+                result[row] = true;
+            }
+        }
+        return result;
+    }();
+
+    constexpr static std::size_t size = std::ranges::count(first_rows, true);
+
+    using hash = hash_displace<size>;
+
+    constexpr static typename hash::layout index = [] {
+        if constexpr (size > name_hash_max_names) {
+            return typename hash::layout {};
+        } else {
+            std::array<std::uint64_t, size> hashes {};
+            std::size_t count = 0;
+            for (std::size_t row = 0; row < rows; ++row) {
+                if (first_rows[row]) {
+                    hashes[count++] = row_hashes[row];
+                }
+            }
+            return hash::build(hashes);
+        }
+    }();
+
+    constexpr static bool hashed = index.built;
+
+    // Row order when hashed, name order for the binary search otherwise
+    constexpr static auto entries = [] {
+        std::array<entry, size> unique {};
+        std::size_t count = 0;
+        for (std::size_t row = 0; row < rows; ++row) {
+            if (first_rows[row]) {
+                unique[count++] = { row_hashes[row], row, mapping_names<MappingTraits>::values[row] };
+            }
+        }
+        if constexpr (!hashed) {
+            std::sort(unique.begin(), unique.end(), [](const entry& a, const entry& b) {
+                return a.name < b.name || (a.name == b.name && a.row < b.row);
+            });
+        }
+        return unique;
+    }();
+};
+
+/**
+ * Name -> Dst lookup: perfect hash slots holding each name and its Dst value,
+ * confirmed with one name compare, or a binary search over the sorted names
+ * when no perfect hash was built
+ */
+template <typename MappingTraits, EnumConcept Dst>
+struct name_table
+{
+    using keys = name_keys<MappingTraits>;
+    using hash = typename keys::hash;
+
+    struct slot
+    {
+        name_words words;
+        std::string_view name;
+        Dst value;
+    };
+
+    constexpr static auto slots = [] {
+        std::array<slot, keys::size> result {};
+        for (std::size_t i = 0; i < keys::size; ++i) {
+            const auto& entry = keys::entries[keys::hashed ? keys::index.slots[i] : i];
+            result[i] = { words_of_name(entry.name), entry.name, mapping_column<MappingTraits, Dst>::at(entry.row) };
+        }
+        return result;
+    }();
+
+    constexpr static Dst fallback = fallback_value<MappingTraits, Dst>();
+
+    // Names of at most 16 bytes are settled by their length and words alone
+    constexpr static bool matches(const slot& entry, std::string_view name, name_words words)
+    {
+        bool same = (entry.name.size() == name.size()) & (entry.words.low == words.low) &
+                    (entry.words.high == words.high);
+        return name.size() <= 16 ? same : same && equal_names(entry.name, name);
+    }
+
+    constexpr static std::optional<Dst> find(std::string_view name)
+    {
+        if constexpr (keys::size == 0) {
+            return std::nullopt;
+        } else if constexpr (keys::hashed) {
+            const name_words words = words_of_name(name);
+            const auto& entry = slots[hash::slot_of(hash_name(name, words), keys::index.seeds)];
+            if (matches(entry, name, words)) {
+                return entry.value;
+            }
+            return std::nullopt;
+        } else {
+            std::size_t base = 0;
+            for (std::size_t length = keys::size; length > 1; length -= length / 2) {
+                std::size_t half = length / 2;
+                base = slots[base + half].name <= name ? base + half : base;
+            }
+            if (slots[base].name == name) {
+                return slots[base].value;
+            }
+            return std::nullopt;
+        }
+    }
+
+    /*
+     * Up to 64 lookups, writing the fallback value for misses and returning them
+     * as a bitmap. Every name is hashed before any slot is compared, so the
+     * independent hash chains and slot loads overlap instead of running one
+     * lookup after another. Names with 16 bytes readable from their start before
+     * readable_end, when given, are loaded without branching on their length.
+     */
+    constexpr static std::uint64_t find_block(const std::string_view* names, std::size_t count, Dst* out,
+                                              const char* readable_end = nullptr)
+    {
+        std::uint64_t misses = 0;
+        if constexpr (keys::hashed && keys::size != 0) {
+            std::array<name_words, 64> words;
+            std::array<std::uint32_t, 64> candidates;
+            for (std::size_t i = 0; i < count; ++i) {
+                const std::string_view name = names[i];
+                const bool padded = !std::is_constant_evaluated() && std::endian::native == std::endian::little &&
+                                    readable_end != nullptr && name.size() <= 16 && readable_end - name.data() >= 16;
+                words[i] = padded ? padded_name_words(name) : words_of_name(name);
+                candidates[i] = static_cast<std::uint32_t>(hash::slot_of(hash_name(name, words[i]), keys::index.seeds));
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& entry = slots[candidates[i]];
+                bool hit = matches(entry, names[i], words[i]);
+                out[i] = hit ? entry.value : fallback;
+                misses |= static_cast<std::uint64_t>(!hit) << i;
+            }
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                auto value = find(names[i]);
+                out[i] = value.value_or(fallback);
+                misses |= static_cast<std::uint64_t>(!value) << i;
+            }
+        }
+        return misses;
+    }
+};
+
+/*
+ * Passes each delimiter-separated field of buffer to field until it returns
+ * false, and returns the offset just past the last field it accepted (with its
+ * delimiter). A trailing delimiter does not start an empty field. Delimiters
+ * are located a vector at a time with SSE2 or AVX2.
+ */
+template <typename Field>
+constexpr std::size_t split_fields(std::string_view buffer, char delimiter, Field&& field)
+{
+    const char* data = buffer.data();
+    const std::size_t size = buffer.size();
+    std::size_t start = 0;
+    std::size_t offset = 0;
+    auto emit = [&](std::size_t end) {
+        if (!field(std::string_view(data + start, end - start))) {
+            return false;
+        }
+        start = end + 1;
+        return true;
+    };
+    if (!std::is_constant_evaluated()) {
+#if defined(__AVX2__)
+        const __m256i delimiters = _mm256_set1_epi8(delimiter);
+        for (; offset + 32 <= size; offset += 32) {
+            __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, delimiters)));
+            for (; mask != 0; mask &= mask - 1) {
+                if (!emit(offset + std::countr_zero(mask))) {
+                    return start;
+                }
+            }
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        for (; offset + 16 <= size; offset += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, delimiters)));
+            for (; mask != 0; mask &= mask - 1) {
+                if (!emit(offset + std::countr_zero(mask))) {
+                    return start;
+                }
+            }
+        }
+#endif
+    }
+    for (; offset < size; ++offset) {
+        if (data[offset] == delimiter && !emit(offset)) {
+            return start;
+        }
+    }
+    if (start < size && !emit(size)) {
+        return start;
+    }
+    return size;
+}
+
+} // namespace enum_cast_detail
+
+/**
+ * Name of an enum value, from the name column of its category's mappings
+ *
+ * @tparam Enum The enum type, whose category's mapping_type holds a std::string_view column
+ * @param value The enum value to name
+ * @return A view of the category's static name storage: the name of the first
+ *         row holding value, or the `default_mapping` name (empty when the
+ *         category declares none) if no row does
+ *
+ * @note One lookup through the backend enum_cast uses for Enum, constant time
+ *       for dense tables and perfect hashes
+ */
+template <EnumConcept Enum>
+    requires enum_cast_detail::NamedMappingTraitsConcept<enum_mapping_traits<enum_category_t<Enum>>>
+constexpr std::string_view enum_to_string(Enum value)
+{
+    using MappingTraits = enum_mapping_traits<enum_category_t<Enum>>;
+    using table = enum_cast_detail::lookup_table_t<MappingTraits, Enum, enum_cast_detail::mapping_row>;
+    return enum_cast_detail::mapping_names<MappingTraits>::values[static_cast<std::size_t>(table::lookup(value))];
+}
+
+/**
+ * Parses an enum value from its name in the category's name column
+ *
+ * @tparam Enum The enum type to produce
+ * @param name The name to look up, compared exactly
+ * @return The Enum value of the first row with that name, or std::nullopt
+ *
+ * @note Names are found through a minimal perfect hash built at compile time,
+ *       with one hash over the name and one compare against the candidate slot
+ */
+template <EnumConcept Enum>
+    requires enum_cast_detail::NamedMappingTraitsConcept<enum_mapping_traits<enum_category_t<Enum>>>
+constexpr std::optional<Enum> enum_from_string(std::string_view name)
+{
+    using MappingTraits = enum_mapping_traits<enum_category_t<Enum>>;
+    return enum_cast_detail::name_table<MappingTraits, Enum>::find(name);
+}
+
+// Outcome of a bulk parse with enum_from_string_split
+struct enum_parse_result
+{
+    std::size_t fields = 0;    // Fields parsed into the output
+    std::size_t unmapped = 0;  // Fields among them without a mapping, flagged in the error bitmap
+    std::size_t consumed = 0;  // Bytes of the buffer taken up by the parsed fields and their delimiters
+};
+
+/**
+ * Parses a run of names into enum values of the category
+ *
+ * @tparam Dst The enum type to produce
+ * @param names The names to look up, compared exactly
+ * @param dst Receives the parsed values; must hold at least names.size() elements
+ * @param errors Error bitmap, bit i of word i / 64 set when names[i] has no
+ *        mapping; must hold at least (names.size() + 63) / 64 words
+ * @return The number of names without a mapping
+ *
+ * @note Unmapped names produce the category's fallback value, as enum_cast does
+ * @note Names are hashed 64 at a time before their slots are compared, so the
+ *       lookups overlap; nothing is allocated and nothing throws
+ */
+template <EnumConcept Dst>
+    requires enum_cast_detail::NamedMappingTraitsConcept<enum_mapping_traits<enum_category_t<Dst>>>
+constexpr std::size_t enum_from_string_n(std::span<const std::string_view> names, std::span<Dst> dst,
+                                         std::span<std::uint64_t> errors)
+{
+    using table = enum_cast_detail::name_table<enum_mapping_traits<enum_category_t<Dst>>, Dst>;
+    assert(dst.size() >= names.size());
+    assert(errors.size() >= (names.size() + 63) / 64);
+    std::size_t unmapped = 0;
+    for (std::size_t done = 0; done < names.size(); done += 64) {
+        std::size_t count = std::min<std::size_t>(64, names.size() - done);
+        errors[done / 64] = table::find_block(names.data() + done, count, dst.data() + done);
+        unmapped += static_cast<std::size_t>(std::popcount(errors[done / 64]));
+    }
+    return unmapped;
+}
+
+/**
+ * Parses the delimiter-separated names in buffer, such as one CSV column or
+ * newline-separated log fields, in place
+ *
+ * @tparam Dst The enum type to produce
+ * @param buffer The text to split; a trailing delimiter does not start another field
+ * @param delimiter The byte separating fields
+ * @param dst Receives the parsed values; parsing stops once it is full
+ * @param errors Error bitmap as for enum_from_string_n, holding at least
+ *        (dst.size() + 63) / 64 words
+ * @return The fields parsed, how many of them have no mapping, and how much of
+ *         the buffer they cover, so that a full dst can be resumed from there
+ *
+ * @note Fields are views into buffer and are never copied; delimiters are found
+ *       a vector at a time and fields are looked up 64 at a time
+ */
+template <EnumConcept Dst>
+    requires enum_cast_detail::NamedMappingTraitsConcept<enum_mapping_traits<enum_category_t<Dst>>>
+constexpr enum_parse_result enum_from_string_split(std::string_view buffer, char delimiter, std::span<Dst> dst,
+                                                   std::span<std::uint64_t> errors)
+{
+    using table = enum_cast_detail::name_table<enum_mapping_traits<enum_category_t<Dst>>, Dst>;
+    assert(errors.size() >= (dst.size() + 63) / 64);
+    enum_parse_result result;
+    std::array<std::string_view, 64> batch {};
+    std::size_t pending = 0;
+    auto flush = [&] {
+        std::uint64_t misses = table::find_block(batch.data(), pending, dst.data() + result.fields,
+                                                 buffer.data() + buffer.size());
+        errors[result.fields / 64] = misses;
+        result.unmapped += static_cast<std::size_t>(std::popcount(misses));
+        result.fields += pending;
+        pending = 0;
+    };
+    result.consumed = enum_cast_detail::split_fields(buffer, delimiter, [&](std::string_view field) {
+        if (result.fields + pending == dst.size()) {
+            return false;
+        }
+        batch[pending++] = field;
+        if (pending == batch.size()) {
+            flush();
+        }
+        return true;
+    });
+    if (pending != 0) {
+        flush();
+    }
+    return result;
+}
+
+/**
+ * Kernels a category can request through
+ * `constexpr static enum_flag_kernel flag_kernel` in its enum_mapping_traits
+ */
+enum class enum_flag_kernel
+{
+    automatic,   // chosen per Src/Dst pair by enum_cast_detail::flag_bit_masks
+    shift,           // requires every mapped bit to move by the same distance
+    bit_masks,       // one select-and-OR per mapped source bit
+    byte_tables,     // one table load per source byte holding mapped bits
+    extract_deposit, // pext then pdep; requires the mapped bits to keep their order
+};
+
+namespace enum_cast_detail {
+
+// Above this many mapped source bits the byte tables beat the per-bit loop
+inline constexpr std::size_t flag_byte_tables_min_bits = 16;
+// From this many mapped bits per table, fewer still pay for their table when it stays this small
+inline constexpr std::size_t flag_byte_tables_min_bits_per_byte = 2;
+inline constexpr std::size_t flag_byte_tables_max_bytes = 4096;
+// Above this many tables, pext/pdep beat the byte tables on mappings that keep the bit order
+inline constexpr std::size_t flag_extract_deposit_min_bytes = 2;
+
+// Flag values are manipulated as the unsigned counterpart of the underlying type
+template <EnumConcept Enum>
+using flag_bits_t = std::make_unsigned_t<std::underlying_type_t<Enum>>;
+
+/**
+ * Per source bit, the destination bits it turns on, and the composite rows that
+ * cannot be reduced to those
+ *
+ * Rows are resolved by the popcount of their source mask:
+ * - Zero rows are dropped: zero always converts to zero, and a zero source value
+ *   can only come from a row that maps some bits to nothing in the other direction
+ * - Single-bit rows contribute their destination mask to their bit
+ * - Composite rows (several source bits, such as ReadWrite) match only when all
+ *   of their bits are set. They are tried longest mask first, and each match
+ *   consumes its bits. A composite that produces exactly what its bits produce
+ *   one at a time, whose bits all have rows of their own, and which shares no
+ *   bit with a composite tried after it, cannot change any result and is
+ *   dropped, so the common case keeps the per-bit kernel alone.
+ */
+template <typename MappingTraits, EnumConcept Src, EnumConcept Dst>
+struct flag_bit_masks
+{
+    using src_bits = flag_bits_t<Src>;
+    using dst_bits = flag_bits_t<Dst>;
+
+    constexpr static int src_width = std::numeric_limits<src_bits>::digits;
+    constexpr static int dst_width = std::numeric_limits<dst_bits>::digits;
+
+    constexpr static src_bits src_at(std::size_t row)
+    {
+        return static_cast<src_bits>(mapping_column<MappingTraits, Src>::values[row]);
+    }
+
+    constexpr static dst_bits dst_at(std::size_t row)
+    {
+        return static_cast<dst_bits>(mapping_column<MappingTraits, Dst>::values[row]);
+    }
+
+    constexpr static auto masks = [] {
+        std::array<dst_bits, src_width> result {};
+        for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+            if (std::has_single_bit(src_at(row))) {
+                result[std::countr_zero(src_at(row))] |= dst_at(row);
+            }
+        }
+        return result;
+    }();
+
+    // Source bits with a single-bit row of their own, including rows that map them to nothing
+    constexpr static src_bits listed = [] {
+        src_bits result = 0;
+        for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+            result |= std::has_single_bit(src_at(row)) ? src_at(row) : src_bits(0);
+        }
+        return result;
+    }();
+
+    constexpr static dst_bits masks_of(src_bits src)
+    {
+        dst_bits result = 0;
+        for (int bit = 0; bit < src_width; ++bit) {
+            if ((src >> bit) & 1u) {
+                result |= masks[bit];
+            }
+        }
+        return result;
+    }
+
+    struct composite
+    {
+        src_bits src = 0;
+        dst_bits dst = 0;
+    };
+
+    // Every composite row in the order they are tried: longest mask first, then row order
+    constexpr static auto composite_rows = [] {
+        constexpr std::size_t count = [] {
+            std::size_t result = 0;
+            for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+                result += std::popcount(src_at(row)) > 1;
+            }
+            return result;
+        }();
+        std::array<std::size_t, count> rows {};
+        std::size_t index = 0;
+        for (std::size_t row = 0; row < mapping_rows<MappingTraits>; ++row) {
+            if (std::popcount(src_at(row)) > 1) {
+                rows[index++] = row;
+            }
+        }
+        std::sort(rows.begin(), rows.end(), [](std::size_t a, std::size_t b) {
+            return std::popcount(src_at(a)) > std::popcount(src_at(b)) ||
+                   (std::popcount(src_at(a)) == std::popcount(src_at(b)) && a < b);
+        });
+        std::array<composite, count> result {};
+        for (std::size_t i = 0; i < count; ++i) {
+            result[i] = { src_at(rows[i]), dst_at(rows[i]) };
+        }
+        return result;
+    }();
+
+    // Walked backwards, so each decision sees which bits the composites tried later still test
+    constexpr static auto composite_kept = [] {
+        std::array<bool, composite_rows.size()> result {};
+        src_bits tested_later = 0;
+        for (std::size_t i = composite_rows.size(); i-- > 0;) {
+            const auto& row = composite_rows[i];
+            result[i] = row.dst != masks_of(row.src) || (row.src & ~listed) != 0 || (row.src & tested_later) != 0;
+            tested_later |= result[i] ? row.src : src_bits(0);
+        }
+        return result;
+    }();
+
+    constexpr static auto composites = [] {
+        std::array<composite, std::ranges::count(composite_kept, true)> result {};
+        std::size_t index = 0;
+        for (std::size_t i = 0; i < composite_rows.size(); ++i) {
+            if (composite_kept[i]) {
+                result[index++] = composite_rows[i];
+            }
+        }
+        return result;
+    }();
+
+    // Destination bits set by at least one source bit
+    constexpr static dst_bits reached = [] {
+        dst_bits result = 0;
+        for (auto mask : masks) {
+            result |= mask;
+        }
+        return result;
+    }();
+
+    // Source bits that set at least one destination bit
+    constexpr static src_bits mapped = [] {
+        src_bits result = 0;
+        for (int bit = 0; bit < src_width; ++bit) {
+            if (masks[bit] != 0) {
+                result |= static_cast<src_bits>(src_bits(1) << bit);
+            }
+        }
+        return result;
+    }();
+
+    constexpr static auto mapped_positions = [] {
+        std::array<int, std::popcount(mapped)> result {};
+        std::size_t count = 0;
+        for (int bit = 0; bit < src_width; ++bit) {
+            if ((mapped >> bit) & 1u) {
+                result[count++] = bit;
+            }
+        }
+        return result;
+    }();
+
+    /*
+     * Set when each mapped bit lands on exactly one destination bit, all at the
+     * same distance `shift` (negative for a right shift)
+     */
+    constexpr static auto uniform_shift = [] {
+        struct result_type
+        {
+            bool uniform = false;
+            int shift = 0;
+        } result;
+        if (mapped == 0) {
+            return result;
+        }
+        int first = mapped_positions[0];
+        result.shift = std::countr_zero(masks[first]) - first;
+        result.uniform = true;
+        for (int bit : mapped_positions) {
+            int target = bit + result.shift;
+            result.uniform = result.uniform && target >= 0 && target < dst_width
+                && masks[bit] == static_cast<dst_bits>(dst_bits(1) << target);
+        }
+        return result;
+    }();
+
+    // Source bytes holding at least one mapped bit
+    constexpr static auto mapped_bytes = [] {
+        constexpr std::size_t count = [] {
+            std::size_t result = 0;
+            for (std::size_t byte = 0; byte < sizeof(src_bits); ++byte) {
+                result += ((mapped >> (byte * 8)) & 0xffu) != 0;
+            }
+            return result;
+        }();
+        std::array<int, count> result {};
+        std::size_t index = 0;
+        for (std::size_t byte = 0; byte < sizeof(src_bits); ++byte) {
+            if (((mapped >> (byte * 8)) & 0xffu) != 0) {
+                result[index++] = static_cast<int>(byte);
+            }
+        }
+        return result;
+    }();
+
+    // For each mapped byte, the destination bits of every possible byte value
+    constexpr static auto byte_tables = [] {
+        std::array<std::array<dst_bits, 256>, mapped_bytes.size()> result {};
+        for (std::size_t table = 0; table < mapped_bytes.size(); ++table) {
+            for (int value = 0; value < 256; ++value) {
+                dst_bits dst = 0;
+                for (int bit = 0; bit < 8; ++bit) {
+                    if ((value >> bit) & 1) {
+                        dst |= masks[mapped_bytes[table] * 8 + bit];
+                    }
+                }
+                result[table][value] = dst;
+            }
+        }
+        return result;
+    }();
+
+    /*
+     * Set when the mapped bits land on distinct single destination bits in the
+     * same order, so the conversion is an extract of `mapped` followed by a
+     * deposit into `deposit`
+     */
+    constexpr static auto order_preserving = [] {
+        struct result_type
+        {
+            bool preserving = false;
+            dst_bits deposit = 0;
+        } result;
+        int previous = -1;
+        result.preserving = true;
+        for (int bit : mapped_positions) {
+            int target = std::countr_zero(masks[bit]);
+            result.preserving = result.preserving && std::has_single_bit(masks[bit]) && target > previous;
+            result.deposit |= masks[bit];
+            previous = target;
+        }
+        return result;
+    }();
+
+    // Whether pext and pdep as wide as both flag types are available outside constant evaluation
+    constexpr static bool extract_deposit_native =
+#if defined(__BMI2__) && defined(__x86_64__)
+        true;
+#elif defined(__BMI2__)
+        src_width <= 32 && dst_width <= 32;
+#else
+        false;
+#endif
+
+    /*
+     * Chosen for the pair of widths: a shift when every bit moves alike, pext and
+     * pdep for order-preserving mappings spread over many bytes, byte tables when
+     * the mapped bits are dense enough per source byte to pay for tables of
+     * dst_bits, and the per-bit loop otherwise
+     */
+    constexpr static enum_flag_kernel kernel = [] {
+        constexpr auto requested = [] {
+            if constexpr (requires { { MappingTraits::flag_kernel } -> std::convertible_to<enum_flag_kernel>; }) {
+                return static_cast<enum_flag_kernel>(MappingTraits::flag_kernel);
+            } else {
+                return enum_flag_kernel::automatic;
+            }
+        }();
+        constexpr std::size_t bits = mapped_positions.size();
+        if constexpr (requested != enum_flag_kernel::automatic) {
+            static_assert(requested != enum_flag_kernel::shift || uniform_shift.uniform || mapped == 0,
+                          "flag_kernel::shift requires every mapped bit to move by the same distance");
+            static_assert(requested != enum_flag_kernel::extract_deposit || order_preserving.preserving,
+                          "flag_kernel::extract_deposit requires the mapped bits to keep their order");
+            return requested;
+        } else if constexpr (uniform_shift.uniform || mapped == 0) {
+            return enum_flag_kernel::shift;
+        } else if constexpr (order_preserving.preserving && extract_deposit_native &&
+                             mapped_bytes.size() > flag_extract_deposit_min_bytes) {
+            return enum_flag_kernel::extract_deposit;
+        } else if constexpr (bits > flag_byte_tables_min_bits ||
+                             (bits > flag_byte_tables_min_bits_per_byte &&
+                              bits >= flag_byte_tables_min_bits_per_byte * mapped_bytes.size() &&
+                              sizeof(byte_tables) <= flag_byte_tables_max_bytes)) {
+            return enum_flag_kernel::byte_tables;
+        } else {
+            return enum_flag_kernel::bit_masks;
+        }
+    }();
+
+    // Source bits named by some row: the listed ones and the bits of the kept composites
+    constexpr static src_bits known = [] {
+        src_bits result = listed;
+        for (const auto& row : composites) {
+            result |= row.src;
+        }
+        return result;
+    }();
+
+    // Mask of the source bits no row names, for one AND per checked conversion
+    constexpr static src_bits unknown = static_cast<src_bits>(~known);
+
+    /*
+     * Matches the composites against src, without branches: each one whose bits
+     * are all still set adds its destination mask and clears its bits. Leaves
+     * the bits no composite consumed in src.
+     */
+    constexpr static dst_bits convert_composites(src_bits& src)
+    {
+        dst_bits dst = 0;
+        for (const auto& row : composites) {
+            auto matched = static_cast<src_bits>((src & row.src) == row.src);
+            dst |= row.dst & static_cast<dst_bits>(dst_bits(0) - static_cast<dst_bits>(matched));
+            src &= static_cast<src_bits>(~(row.src & static_cast<src_bits>(src_bits(0) - matched)));
+        }
+        return dst;
+    }
+
+    constexpr static dst_bits convert(src_bits src)
+    {
+        if constexpr (composites.empty()) {
+            return convert_bits(src);
+        } else {
+            dst_bits dst = convert_composites(src);
+            return dst | convert_bits(src);
+        }
+    }
+
+    struct checked_bits
+    {
+        dst_bits dst;
+        src_bits unmapped;
+    };
+
+    /*
+     * As convert, also returning the source bits that did not map. Bits of a
+     * composite that was only partly set count as unmapped too, so with
+     * composites the AND applies to the bits they left over.
+     */
+    constexpr static checked_bits convert_checked(src_bits src)
+    {
+        if constexpr (composites.empty()) {
+            return { convert_bits(src), static_cast<src_bits>(src & unknown) };
+        } else {
+            dst_bits dst = convert_composites(src);
+            return { dst | convert_bits(src), static_cast<src_bits>(src & static_cast<src_bits>(~listed)) };
+        }
+    }
+
+    // The per-bit kernel alone, for the bits left once the composites are matched
+    constexpr static dst_bits convert_bits(src_bits src)
+    {
+        if constexpr (mapped == 0) {
+            return 0;
+        } else if constexpr (kernel == enum_flag_kernel::shift) {
+            auto bits = static_cast<std::uint64_t>(src & mapped);
+            if constexpr (uniform_shift.shift >= 0) {
+                return static_cast<dst_bits>(bits << uniform_shift.shift);
+            } else {
+                return static_cast<dst_bits>(bits >> -uniform_shift.shift);
+            }
+        } else if constexpr (kernel == enum_flag_kernel::byte_tables) {
+            dst_bits dst = 0;
+            for (std::size_t table = 0; table < mapped_bytes.size(); ++table) {
+                dst |= byte_tables[table][(src >> (mapped_bytes[table] * 8)) & 0xffu];
+            }
+            return dst;
+        } else {
+#if defined(__BMI2__)
+            if constexpr (kernel == enum_flag_kernel::extract_deposit && extract_deposit_native) {
+                if (!std::is_constant_evaluated()) {
+                    return extract_deposit(src);
+                }
+            }
+#endif
+            // Also the constant-evaluated and non-BMI2 form of extract_deposit, which it equals bit for bit
+            dst_bits dst = 0;
+            for (int bit : mapped_positions) {
+                auto select = static_cast<dst_bits>(dst_bits(0) - static_cast<dst_bits>((src >> bit) & 1u));
+                dst |= masks[bit] & select;
+            }
+            return dst;
+        }
+    }
+
+#if defined(__BMI2__)
+    // The 32-bit instructions when both types fit them, which 32-bit x86 also has
+    static dst_bits extract_deposit(src_bits src) noexcept
+    {
+        if constexpr (src_width <= 32 && dst_width <= 32) {
+            return static_cast<dst_bits>(_pdep_u32(_pext_u32(src, mapped), order_preserving.deposit));
+        } else {
+            return static_cast<dst_bits>(_pdep_u64(_pext_u64(src, mapped), order_preserving.deposit));
+        }
+    }
+#endif
+};
+
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+/**
+ * Nibble lookup tables for 32-bit flag enums: for each source nibble holding
+ * mapped bits and each destination byte those bits reach, the destination byte
+ * produced by every nibble value. Sized for one pshufb operand each.
+ */
+template <typename Masks>
+struct flag_nibble_tables
+{
+    static_assert(sizeof(typename Masks::src_bits) == 4 && sizeof(typename Masks::dst_bits) == 4);
+
+    constexpr static auto positions = [](auto mask_of, auto width) {
+        constexpr std::size_t count = [&] {
+            std::size_t result = 0;
+            for (int position = 0; position < decltype(width)::value; ++position) {
+                result += mask_of(position) != 0;
+            }
+            return result;
+        }();
+        std::array<int, count> result {};
+        std::size_t index = 0;
+        for (int position = 0; position < decltype(width)::value; ++position) {
+            if (mask_of(position) != 0) {
+                result[index++] = position;
+            }
+        }
+        return result;
+    };
+
+    constexpr static auto nibbles = positions(
+        [](int nibble) { return (Masks::mapped >> (nibble * 4)) & 0xfu; }, std::integral_constant<int, 8> {});
+
+    constexpr static auto dst_bytes = positions(
+        [](int byte) { return (Masks::reached >> (byte * 8)) & 0xffu; },
+        std::integral_constant<int, 4> {});
+
+    constexpr static auto tables = [] {
+        std::array<std::array<std::array<std::uint8_t, 16>, dst_bytes.size()>, nibbles.size()> result {};
+        for (std::size_t n = 0; n < nibbles.size(); ++n) {
+            for (int value = 0; value < 16; ++value) {
+                typename Masks::dst_bits dst = 0;
+                for (int bit = 0; bit < 4; ++bit) {
+                    if ((value >> bit) & 1) {
+                        dst |= Masks::masks[nibbles[n] * 4 + bit];
+                    }
+                }
+                for (std::size_t b = 0; b < dst_bytes.size(); ++b) {
+                    result[n][b][value] = static_cast<std::uint8_t>(dst >> (dst_bytes[b] * 8));
+                }
+            }
+        }
+        return result;
+    }();
+};
+
+/*
+ * Vector nibble-lookup kernel for 32-bit flag enums. Each mapped source nibble
+ * is isolated, broadcast across its lane and used as a pshufb index into the
+ * table of every destination byte it reaches. Returns the number of elements
+ * converted; the caller finishes the tail.
+ */
+template <typename Masks>
+std::size_t flag_bits_batch_simd(const void* src, void* dst, std::size_t count)
+{
+    using Tables = flag_nibble_tables<Masks>;
+    const auto* in = static_cast<const std::uint8_t*>(src);
+    auto* out = static_cast<std::uint8_t*>(dst);
+    std::size_t done = 0;
+#if defined(__AVX2__)
+    const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+    const __m256i lane_base = _mm256_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+                                               0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+    for (; done + 8 <= count; done += 8) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + done * 4));
+        __m256i result = _mm256_setzero_si256();
+        for (std::size_t n = 0; n < Tables::nibbles.size(); ++n) {
+            int nibble = Tables::nibbles[n];
+            __m256i isolated = _mm256_and_si256(nibble & 1 ? _mm256_srli_epi32(value, 4) : value, low_nibbles);
+            __m256i index = _mm256_shuffle_epi8(isolated, _mm256_add_epi8(lane_base, _mm256_set1_epi8(static_cast<char>(nibble / 2))));
+            for (std::size_t b = 0; b < Tables::dst_bytes.size(); ++b) {
+                __m256i table = _mm256_broadcastsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(Tables::tables[n][b].data())));
+                __m256i byte_mask = _mm256_set1_epi32(0xff << (Tables::dst_bytes[b] * 8));
+                result = _mm256_or_si256(result, _mm256_and_si256(_mm256_shuffle_epi8(table, index), byte_mask));
+            }
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + done * 4), result);
+    }
+#else
+    const __m128i low_nibbles = _mm_set1_epi8(0x0f);
+    const __m128i lane_base = _mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+    for (; done + 4 <= count; done += 4) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done * 4));
+        __m128i result = _mm_setzero_si128();
+        for (std::size_t n = 0; n < Tables::nibbles.size(); ++n) {
+            int nibble = Tables::nibbles[n];
+            __m128i isolated = _mm_and_si128(nibble & 1 ? _mm_srli_epi32(value, 4) : value, low_nibbles);
+            __m128i index = _mm_shuffle_epi8(isolated, _mm_add_epi8(lane_base, _mm_set1_epi8(static_cast<char>(nibble / 2))));
+            for (std::size_t b = 0; b < Tables::dst_bytes.size(); ++b) {
+                __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Tables::tables[n][b].data()));
+                __m128i byte_mask = _mm_set1_epi32(0xff << (Tables::dst_bytes[b] * 8));
+                result = _mm_or_si128(result, _mm_and_si128(_mm_shuffle_epi8(table, index), byte_mask));
+            }
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done * 4), result);
+    }
+#endif
+    return done;
+}
+#endif
+
+} // namespace enum_cast_detail
+
+
+/**
+ * @brief Converts bitwise flag enum values from one type to another within the same category
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum flags value to convert
+ * @return The equivalent enum flags value in the destination type
+ * @note Source and destination enums must belong to the same category
+ * @note Each bit position in the source is mapped to its corresponding bit in the destination
+ * @note Rows with several source bits (such as ReadWrite) match only when all of
+ *       their bits are set, longest mask first, and consume the bits they match;
+ *       rows with a zero source value map zero to zero
+ * @note If a bit has no mapping, it will be dropped in the conversion
+ * @note The mapping is folded at compile time into a shift-and-mask, a per-bit
+ *       mask table or per-byte tables (see enum_flag_kernel); the conversion
+ *       itself does not branch
+ * @note Usable in constant expressions with every kernel, so translated masks can
+ *       be folded into constexpr tables
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr Dst enum_flag_bits_cast(Src src)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    using Category = enum_category_t<Src>;
+    using MappingTraits = enum_mapping_traits<Category>;
+    using Masks = enum_cast_detail::flag_bit_masks<MappingTraits, Src, Dst>;
+    // Evaluates the selected kernel at compile time, so every conversion stays usable in constant expressions
+    static_assert(Masks::convert(0) == 0 && Masks::convert(static_cast<typename Masks::src_bits>(~Masks::known)) == 0 &&
+                      Masks::convert_bits(Masks::mapped) == Masks::reached,
+                  "The flag conversion kernel must be constant-evaluable and agree with the mapping table");
+    if constexpr (enum_cast_detail::instrumented<MappingTraits>) {
+        if (!std::is_constant_evaluated()) {
+            auto [dst, unmapped] = Masks::convert_checked(static_cast<typename Masks::src_bits>(src));
+            enum_cast_detail::record_conversion<Category, Src, Dst>(enum_cast_operation::flag_bits_cast, unmapped != 0);
+            return static_cast<Dst>(static_cast<std::underlying_type_t<Dst>>(dst));
+        }
+    }
+    auto dst = Masks::convert(static_cast<typename Masks::src_bits>(src));
+    return static_cast<Dst>(static_cast<std::underlying_type_t<Dst>>(dst));
+}
+
+// Outcome of enum_flag_bits_cast_checked
+template <EnumConcept Dst, EnumConcept Src>
+struct enum_flag_bits_cast_result
+{
+    Dst value {};     // The converted flags, as enum_flag_bits_cast returns them
+    Src unmapped {};  // Source bits dropped by the conversion, zero when nothing was lost
+};
+
+/**
+ * Converts flag values like enum_flag_bits_cast and reports the source bits
+ * that have no mapping
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum flags value to convert
+ * @return The converted value and the mask of the source bits it dropped
+ *
+ * @note A bit counts as mapped when a row covers it, even a row mapping it to
+ *       nothing; bits of a composite row that is only partly set, and that have
+ *       no rows of their own, count as unmapped
+ * @note The unmapped bits are a single AND against the complement of the known
+ *       source bits, computed at compile time
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr enum_flag_bits_cast_result<Dst, Src> enum_flag_bits_cast_checked(Src src)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    using Category = enum_category_t<Src>;
+    using MappingTraits = enum_mapping_traits<Category>;
+    using Masks = enum_cast_detail::flag_bit_masks<MappingTraits, Src, Dst>;
+    auto [dst, unmapped] = Masks::convert_checked(static_cast<typename Masks::src_bits>(src));
+    if constexpr (enum_cast_detail::instrumented<MappingTraits>) {
+        if (!std::is_constant_evaluated()) {
+            enum_cast_detail::record_conversion<Category, Src, Dst>(enum_cast_operation::flag_bits_cast, unmapped != 0);
+        }
+    }
+    return { static_cast<Dst>(static_cast<std::underlying_type_t<Dst>>(dst)),
+             static_cast<Src>(static_cast<std::underlying_type_t<Src>>(unmapped)) };
+}
+
+/**
+ * Strict flag conversion: converts src only when every set bit has a mapping
+ *
+ * @return The converted value, or std::nullopt when the conversion would drop bits
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr std::optional<Dst> try_enum_flag_bits_cast(Src src)
+{
+    auto result = enum_flag_bits_cast_checked<Dst>(src);
+    if (result.unmapped != Src {}) {
+        return std::nullopt;
+    }
+    return result.value;
+}
+
+/**
+ * @brief Converts a contiguous run of flag enum values from one type to another within the same category
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The source enum flags values to convert
+ * @param dst Receives the converted values; must hold at least src.size() elements
+ * @note Each element converts exactly as enum_flag_bits_cast would
+ * @note 32-bit flag enums use SSSE3/AVX2 nibble lookups; other widths run the
+ *       scalar kernel of the pair, and shift mappings are left to the compiler's vectorizer
+ */
+template <EnumConcept Dst, EnumConcept Src>
+constexpr void enum_flag_bits_cast_n(std::span<const Src> src, std::span<Dst> dst)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    assert(dst.size() >= src.size());
+    using MappingTraits = enum_mapping_traits<enum_category_t<Src>>;
+    using Masks = enum_cast_detail::flag_bit_masks<MappingTraits, Src, Dst>;
+    std::size_t done = 0;
+    if (!std::is_constant_evaluated()) {
+        if constexpr (!Masks::composites.empty() || Masks::kernel == enum_flag_kernel::shift || Masks::mapped == 0 ||
+                      enum_cast_detail::instrumented<MappingTraits>) {
+            // Falls through to the scalar loop, which is branchless and vectorizes as is and records instrumented casts
+#if defined(__SSSE3__) || defined(__AVX2__)
+        } else if constexpr (sizeof(Src) == 4 && sizeof(Dst) == 4) {
+            done = enum_cast_detail::flag_bits_batch_simd<Masks>(src.data(), dst.data(), src.size());
+#endif
+        }
+    }
+    for (; done < src.size(); ++done) {
+        dst[done] = enum_flag_bits_cast<Dst>(src[done]);
+    }
+}
+
+// Takes a mutable source span, as std::span(values) deduces for a non-const container
+template <EnumConcept Dst, EnumConcept Src>
+    requires(!std::is_const_v<Src>)
+constexpr void enum_flag_bits_cast_n(std::span<Src> src, std::span<Dst> dst)
+{
+    enum_flag_bits_cast_n<Dst>(std::span<const Src>(src), dst);
+}
+
+/**
+ * Opt-in for the bitwise operators of enum_flags, specialized per flag enum:
+ * `template <> struct enum_flags_enabled<lib_a::Permission> : std::true_type {};`
+ *
+ * Enums without the specialization see none of the operators, so they cannot
+ * collide with another library's operators or widen overload resolution.
+ */
+template <EnumConcept Enum>
+struct enum_flags_enabled : std::false_type {};
+
+template <EnumConcept Enum>
+inline constexpr bool enum_flags_enabled_v = enum_flags_enabled<Enum>::value;
+
+template <typename T>
+concept EnumFlagsConcept = EnumConcept<T> && enum_flags_enabled_v<T>;
+
+/*
+ * Bitwise operators kept in the enum domain, for flag enums that opted in
+ * through enum_flags_enabled
+ *
+ * ADL never finds the operators on raw enums, since they live outside the
+ * enums' namespaces; bring them into the scopes that want them with
+ * `using namespace enum_flags;` or `using enum_flags::operator|;`. The flags<E>
+ * wrapper needs no using: its operators are hidden friends.
+ */
+namespace enum_flags {
+
+template <EnumFlagsConcept Enum>
+constexpr Enum operator|(Enum a, Enum b) noexcept
+{
+    return static_cast<Enum>(static_cast<std::underlying_type_t<Enum>>(enum_cast_detail::flag_bits_t<Enum>(a) |
+                                                                       enum_cast_detail::flag_bits_t<Enum>(b)));
+}
+
+template <EnumFlagsConcept Enum>
+constexpr Enum operator&(Enum a, Enum b) noexcept
+{
+    return static_cast<Enum>(static_cast<std::underlying_type_t<Enum>>(enum_cast_detail::flag_bits_t<Enum>(a) &
+                                                                       enum_cast_detail::flag_bits_t<Enum>(b)));
+}
+
+template <EnumFlagsConcept Enum>
+constexpr Enum operator^(Enum a, Enum b) noexcept
+{
+    return static_cast<Enum>(static_cast<std::underlying_type_t<Enum>>(enum_cast_detail::flag_bits_t<Enum>(a) ^
+                                                                       enum_cast_detail::flag_bits_t<Enum>(b)));
+}
+
+// Requires a fixed underlying type in constant expressions, where the complement must be a valid value
+template <EnumFlagsConcept Enum>
+constexpr Enum operator~(Enum a) noexcept
+{
+    return static_cast<Enum>(static_cast<std::underlying_type_t<Enum>>(
+        static_cast<enum_cast_detail::flag_bits_t<Enum>>(~enum_cast_detail::flag_bits_t<Enum>(a))));
+}
+
+template <EnumFlagsConcept Enum>
+constexpr Enum& operator|=(Enum& a, Enum b) noexcept
+{
+    return a = a | b;
+}
+
+template <EnumFlagsConcept Enum>
+constexpr Enum& operator&=(Enum& a, Enum b) noexcept
+{
+    return a = a & b;
+}
+
+template <EnumFlagsConcept Enum>
+constexpr Enum& operator^=(Enum& a, Enum b) noexcept
+{
+    return a = a ^ b;
+}
+
+/**
+ * A set of flags of one enum, with the bitwise operators as hidden friends
+ *
+ * Holds the enum itself, so it has the enum's size and layout and every
+ * operation folds to the plain integer instruction. Enumerators convert to it
+ * implicitly; converting back is explicit, which keeps the built-in integer
+ * operators of unscoped enums out of overload resolution.
+ */
+template <EnumFlagsConcept Enum>
+class flags
+{
+public:
+    using enum_type = Enum;
+    using bits_type = enum_cast_detail::flag_bits_t<Enum>;
+
+    constexpr flags() noexcept = default;
+    constexpr flags(Enum value) noexcept : value_(value) {}
+
+    constexpr Enum value() const noexcept { return value_; }
+    constexpr bits_type bits() const noexcept { return static_cast<bits_type>(value_); }
+    constexpr explicit operator Enum() const noexcept { return value_; }
+    constexpr explicit operator bool() const noexcept { return bits() != 0; }
+
+    // Whether every flag of other is set
+    constexpr bool contains(flags other) const noexcept { return (bits() & other.bits()) == other.bits(); }
+    // Whether any flag of other is set
+    constexpr bool intersects(flags other) const noexcept { return (bits() & other.bits()) != 0; }
+
+    friend constexpr flags operator|(flags a, flags b) noexcept { return from_bits(a.bits() | b.bits()); }
+    friend constexpr flags operator&(flags a, flags b) noexcept { return from_bits(a.bits() & b.bits()); }
+    friend constexpr flags operator^(flags a, flags b) noexcept { return from_bits(a.bits() ^ b.bits()); }
+    friend constexpr flags operator~(flags a) noexcept { return from_bits(static_cast<bits_type>(~a.bits())); }
+
+    friend constexpr flags& operator|=(flags& a, flags b) noexcept { return a = a | b; }
+    friend constexpr flags& operator&=(flags& a, flags b) noexcept { return a = a & b; }
+    friend constexpr flags& operator^=(flags& a, flags b) noexcept { return a = a ^ b; }
+
+    friend constexpr bool operator==(flags a, flags b) noexcept = default;
+
+private:
+    constexpr static flags from_bits(bits_type bits) noexcept
+    {
+        return flags(static_cast<Enum>(static_cast<std::underlying_type_t<Enum>>(bits)));
+    }
+
+    Enum value_ {};
+};
+
+} // namespace enum_flags
+
+/**
+ * Converts a flags set like enum_flag_bits_cast converts its value
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type, opted in through enum_flags_enabled
+ */
+template <EnumConcept Dst, EnumFlagsConcept Src>
+constexpr Dst enum_flag_bits_cast(enum_flags::flags<Src> src)
+{
+    return enum_flag_bits_cast<Dst>(src.value());
+}
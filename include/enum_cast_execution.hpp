@@ -0,0 +1,117 @@
+/*
+ * enum_cast_execution.hpp - Batch conversions with standard execution policies
+ *
+ * Overloads of enum_cast_n and enum_flag_bits_cast_n taking a
+ * std::execution policy as their first argument, for arrays large enough to
+ * spread over several cores:
+ *
+ *     enum_cast_n<lib_a::Color>(std::execution::par_unseq, std::span(src), std::span(dst));
+ *
+ * The arrays are cut into chunks that fit in a core's L2 cache together with
+ * their output, and every chunk is converted by the sequential batch kernel.
+ * How the chunks are scheduled is up to the standard library; libstdc++, for
+ * instance, runs parallel policies on TBB when it is available and requires
+ * linking it then.
+ */
+
+#pragma once
+
+#include <enum_cast.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <execution>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace enum_cast_detail {
+
+// Source and destination bytes converted per task
+inline constexpr std::size_t parallel_chunk_bytes = std::size_t(1) << 17;
+
+template <typename ExecutionPolicy>
+concept ExecutionPolicyConcept = std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>;
+
+/*
+ * Calls convert(first, count) over consecutive chunks of a count-element array
+ * under policy, or once over the whole array when it is not worth splitting
+ */
+template <typename ExecutionPolicy, typename Convert>
+void for_each_chunk(ExecutionPolicy&& policy, std::size_t count, std::size_t element_bytes, Convert convert)
+{
+    const std::size_t chunk = std::max<std::size_t>(1, parallel_chunk_bytes / element_bytes);
+    if (count <= chunk) {
+        convert(std::size_t(0), count);
+        return;
+    }
+    std::vector<std::size_t> starts((count + chunk - 1) / chunk);
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+        starts[i] = i * chunk;
+    }
+    std::for_each(std::forward<ExecutionPolicy>(policy), starts.begin(), starts.end(),
+                  [&](std::size_t start) { convert(start, std::min(chunk, count - start)); });
+}
+
+} // namespace enum_cast_detail
+
+/**
+ * Converts a contiguous run of enum values like enum_cast_n, spreading the
+ * work over cache-sized chunks as policy allows
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param policy A standard execution policy, e.g. std::execution::par_unseq
+ * @param src The source enum values to convert
+ * @param dst Receives the converted values; must hold at least src.size() elements
+ *
+ * @note Each element converts exactly as enum_cast would
+ */
+template <EnumConcept Dst, EnumConcept Src, enum_cast_detail::ExecutionPolicyConcept ExecutionPolicy>
+void enum_cast_n(ExecutionPolicy&& policy, std::span<const Src> src, std::span<Dst> dst)
+{
+    assert(dst.size() >= src.size());
+    enum_cast_detail::for_each_chunk(std::forward<ExecutionPolicy>(policy), src.size(), sizeof(Src) + sizeof(Dst),
+                                     [&](std::size_t start, std::size_t count) {
+                                         enum_cast_n<Dst>(src.subspan(start, count), dst.subspan(start, count));
+                                     });
+}
+
+// Takes a mutable source span, as std::span(values) deduces for a non-const container
+template <EnumConcept Dst, EnumConcept Src, enum_cast_detail::ExecutionPolicyConcept ExecutionPolicy>
+    requires(!std::is_const_v<Src>)
+void enum_cast_n(ExecutionPolicy&& policy, std::span<Src> src, std::span<Dst> dst)
+{
+    enum_cast_n<Dst>(std::forward<ExecutionPolicy>(policy), std::span<const Src>(src), dst);
+}
+
+/**
+ * Converts a contiguous run of flag enum values like enum_flag_bits_cast_n,
+ * spreading the work over cache-sized chunks as policy allows
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param policy A standard execution policy, e.g. std::execution::par_unseq
+ * @param src The source enum flags values to convert
+ * @param dst Receives the converted values; must hold at least src.size() elements
+ *
+ * @note Each element converts exactly as enum_flag_bits_cast would
+ */
+template <EnumConcept Dst, EnumConcept Src, enum_cast_detail::ExecutionPolicyConcept ExecutionPolicy>
+void enum_flag_bits_cast_n(ExecutionPolicy&& policy, std::span<const Src> src, std::span<Dst> dst)
+{
+    assert(dst.size() >= src.size());
+    enum_cast_detail::for_each_chunk(std::forward<ExecutionPolicy>(policy), src.size(), sizeof(Src) + sizeof(Dst),
+                                     [&](std::size_t start, std::size_t count) {
+                                         enum_flag_bits_cast_n<Dst>(src.subspan(start, count), dst.subspan(start, count));
+                                     });
+}
+
+// Takes a mutable source span, as std::span(values) deduces for a non-const container
+template <EnumConcept Dst, EnumConcept Src, enum_cast_detail::ExecutionPolicyConcept ExecutionPolicy>
+    requires(!std::is_const_v<Src>)
+void enum_flag_bits_cast_n(ExecutionPolicy&& policy, std::span<Src> src, std::span<Dst> dst)
+{
+    enum_flag_bits_cast_n<Dst>(std::forward<ExecutionPolicy>(policy), std::span<const Src>(src), dst);
+}
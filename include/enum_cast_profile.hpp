@@ -0,0 +1,289 @@
+/*
+ * enum_cast_profile.hpp - Call and miss counters for instrumented categories
+ *
+ * A category opts in by naming enum_cast_counters as its instrumentation
+ * policy; every other category compiles to the uninstrumented code:
+ *
+ *     template <>
+ *     struct enum_mapping_traits<ColorTag> {
+ *         using instrumentation = enum_cast_counters;
+ *         // mapping_type and mappings
+ *     };
+ *
+ * Key components:
+ * - enum_cast_counters: Instrumentation policy counting calls and misses per
+ *   (category, Src, Dst) pair and conversion
+ * - enum_cast_profile: Totals over all threads, hottest pair first
+ * - enum_cast_profile_dump: The same totals as a text table
+ *
+ * Each thread counts into counters of its own, one cache line per pair, with
+ * plain relaxed stores; registering a thread's counters takes a lock once per
+ * pair, and a thread that exits folds its counts into the totals.
+ */
+
+#pragma once
+
+#include <enum_cast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace enum_cast_detail {
+
+template <typename T>
+constexpr auto type_signature()
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return std::string_view(__PRETTY_FUNCTION__);
+#elif defined(_MSC_VER)
+    return std::string_view(__FUNCSIG__);
+#else
+    return std::string_view();
+#endif
+}
+
+/*
+ * Name of T as spelled by the compiler in the signature of type_signature<T>:
+ * "... [with T = ns::E]" on GCC, "... [T = ns::E]" on Clang and
+ * "...type_signature<enum ns::E>(void)" on MSVC; empty when not recognized
+ */
+template <typename T>
+constexpr std::string_view type_name()
+{
+    std::string_view signature = type_signature<T>();
+#if defined(_MSC_VER) && !defined(__clang__)
+    constexpr std::string_view prefix = "type_signature<";
+    constexpr std::string_view suffix = ">(void)";
+#else
+    constexpr std::string_view prefix = "T = ";
+    constexpr std::string_view suffix = "]";
+#endif
+    auto start = signature.find(prefix);
+    if (start == std::string_view::npos || !signature.ends_with(suffix)) {
+        return {};
+    }
+    signature.remove_suffix(suffix.size());
+    signature.remove_prefix(start + prefix.size());
+    for (std::string_view keyword : { "enum ", "struct ", "class " }) {
+        if (signature.starts_with(keyword)) {
+            signature.remove_prefix(keyword.size());
+        }
+    }
+    return signature;
+}
+
+// One instrumented conversion: a (category, Src, Dst) pair and an operation
+struct profile_site
+{
+    std::string_view category;
+    std::string_view source;
+    std::string_view destination;
+    enum_cast_operation operation;
+    std::optional<enum_lookup_strategy> strategy;
+    bool shared_row_index = false;
+};
+
+template <typename Category, EnumConcept Src, EnumConcept Dst, enum_cast_operation Operation>
+struct profile_site_of
+{
+    constexpr static profile_site site = [] {
+        // Taken from the backend enum_cast dispatches to, so shared row indexes are reported as such
+        std::optional<enum_lookup_strategy> strategy;
+        bool shared_row_index = false;
+        if constexpr (Operation == enum_cast_operation::enum_cast) {
+            using MappingTraits = enum_mapping_traits<Category>;
+            strategy = select_lookup_strategy<MappingTraits, Src>();
+            shared_row_index = is_row_indexed_table<lookup_table_t<MappingTraits, Src, Dst>>;
+        }
+        return profile_site { type_name<Category>(), type_name<Src>(), type_name<Dst>(), Operation, strategy,
+                              shared_row_index };
+    }();
+};
+
+// Counters of one thread for one site, on a cache line of their own
+struct alignas(64) profile_counters
+{
+    const profile_site* site;
+    // Written by the owning thread only; atomic so that a dump may read them meanwhile
+    std::atomic<std::uint64_t> calls { 0 };
+    std::atomic<std::uint64_t> misses { 0 };
+
+    void add(bool missed) noexcept
+    {
+        calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        misses.store(misses.load(std::memory_order_relaxed) + (missed ? 1 : 0), std::memory_order_relaxed);
+    }
+};
+
+struct profile_state
+{
+    std::mutex lock;
+    // Counters of the running threads
+    std::vector<const profile_counters*> live;
+    // Counts of exited threads, per site
+    std::vector<std::pair<const profile_site*, std::array<std::uint64_t, 2>>> retired;
+};
+
+// Constant-initialized, so conversions in other static initializers find it ready
+constinit inline profile_state profile {};
+
+// The calling thread's counters for one site, registered while the thread runs
+class profile_thread_counters
+{
+public:
+    explicit profile_thread_counters(const profile_site& site) : counters_ { &site }
+    {
+        std::lock_guard lock(profile.lock);
+        profile.live.push_back(&counters_);
+    }
+
+    profile_thread_counters(const profile_thread_counters&) = delete;
+    profile_thread_counters& operator=(const profile_thread_counters&) = delete;
+
+    ~profile_thread_counters()
+    {
+        std::lock_guard lock(profile.lock);
+        std::erase(profile.live, &counters_);
+        auto calls = counters_.calls.load(std::memory_order_relaxed);
+        auto misses = counters_.misses.load(std::memory_order_relaxed);
+        auto it = std::find_if(profile.retired.begin(), profile.retired.end(),
+                               [&](const auto& entry) { return entry.first == counters_.site; });
+        if (it == profile.retired.end()) {
+            profile.retired.push_back({ counters_.site, { calls, misses } });
+        } else {
+            it->second[0] += calls;
+            it->second[1] += misses;
+        }
+    }
+
+    void add(bool missed) noexcept
+    {
+        counters_.add(missed);
+    }
+
+private:
+    profile_counters counters_;
+};
+
+template <typename Category, EnumConcept Src, EnumConcept Dst, enum_cast_operation Operation>
+void count_conversion(bool missed)
+{
+    thread_local profile_thread_counters counters(profile_site_of<Category, Src, Dst, Operation>::site);
+    counters.add(missed);
+}
+
+constexpr std::string_view strategy_name(enum_lookup_strategy strategy)
+{
+    switch (strategy) {
+    case enum_lookup_strategy::automatic:
+        return "automatic";
+    case enum_lookup_strategy::linear_scan:
+        return "linear_scan";
+    case enum_lookup_strategy::dense_table:
+        return "dense_table";
+    case enum_lookup_strategy::sorted_array:
+        return "sorted_array";
+    case enum_lookup_strategy::perfect_hash:
+        return "perfect_hash";
+    case enum_lookup_strategy::masked_dense_table:
+        return "masked_dense_table";
+    }
+    return {};
+}
+
+} // namespace enum_cast_detail
+
+/**
+ * Instrumentation policy counting conversions and misses per thread
+ *
+ * @note A miss is an enum_cast that returned the fallback value, or a flag
+ *       conversion that dropped source bits
+ * @note Conversions evaluated at compile time are not counted
+ */
+struct enum_cast_counters
+{
+    template <typename Category, EnumConcept Src, EnumConcept Dst>
+    static void record(enum_cast_operation operation, bool missed)
+    {
+        if (operation == enum_cast_operation::enum_cast) {
+            enum_cast_detail::count_conversion<Category, Src, Dst, enum_cast_operation::enum_cast>(missed);
+        } else {
+            enum_cast_detail::count_conversion<Category, Src, Dst, enum_cast_operation::flag_bits_cast>(missed);
+        }
+    }
+};
+
+// Counts of one instrumented pair, summed over threads
+struct enum_cast_profile_entry
+{
+    std::string_view category;
+    std::string_view source;
+    std::string_view destination;
+    enum_cast_operation operation;
+    std::optional<enum_lookup_strategy> strategy; // Backend of the lookup; empty for flag conversions
+    bool shared_row_index = false;                 // Whether the backend indexes rows shared by every destination
+    std::uint64_t calls = 0;
+    std::uint64_t misses = 0;
+};
+
+/**
+ * Snapshot of the counters of every instrumented pair used so far
+ *
+ * @return One entry per pair and operation, ordered by descending call count
+ *
+ * @note Counts of running threads are read without stopping them, so a
+ *       snapshot taken during conversions may lag behind by a few calls
+ */
+inline std::vector<enum_cast_profile_entry> enum_cast_profile()
+{
+    using enum_cast_detail::profile;
+    std::vector<enum_cast_profile_entry> result;
+    std::vector<const enum_cast_detail::profile_site*> sites;
+    auto add = [&](const enum_cast_detail::profile_site* site, std::uint64_t calls, std::uint64_t misses) {
+        auto at = static_cast<std::size_t>(std::find(sites.begin(), sites.end(), site) - sites.begin());
+        if (at == sites.size()) {
+            sites.push_back(site);
+            result.push_back({ site->category, site->source, site->destination, site->operation, site->strategy,
+                               site->shared_row_index });
+        }
+        result[at].calls += calls;
+        result[at].misses += misses;
+    };
+    {
+        std::lock_guard lock(profile.lock);
+        for (const auto* counters : profile.live) {
+            add(counters->site, counters->calls.load(std::memory_order_relaxed),
+                counters->misses.load(std::memory_order_relaxed));
+        }
+        for (const auto& [site, counts] : profile.retired) {
+            add(site, counts[0], counts[1]);
+        }
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const auto& a, const auto& b) { return a.calls > b.calls; });
+    return result;
+}
+
+/**
+ * Writes enum_cast_profile() as one line per pair:
+ * "<calls> calls <misses> misses <category>: <Src> -> <Dst> [<backend>]", where a
+ * shared row index reads "[row_index <backend of the index>]"
+ */
+inline void enum_cast_profile_dump(std::ostream& out)
+{
+    for (const auto& entry : enum_cast_profile()) {
+        out << entry.calls << " calls " << entry.misses << " misses " << entry.category << ": " << entry.source
+            << " -> " << entry.destination << " [" << (entry.shared_row_index ? "row_index " : "")
+            << (entry.strategy ? enum_cast_detail::strategy_name(*entry.strategy) : std::string_view("flag_bits"))
+            << "]\n";
+    }
+}
@@ -0,0 +1,286 @@
+/*
+ * enum_cast_registry.hpp - Enum mappings registered at run time
+ *
+ * Some mappings are only known once the program runs, loaded from plugins or
+ * configuration, and cannot be written as enum_mapping_traits specializations.
+ * enum_cast_registry builds the same lookup tables enum_cast uses from rows
+ * given at run time and publishes them for lock-free lookups.
+ *
+ * Key components:
+ * - enum_cast_registry: One registry per (category, Src, Dst) triple
+ * - registered_enum_cast, try_registered_enum_cast: Lookups through it
+ *
+ * Tables are published retire-until-reclaim: readers load the current table
+ * through an atomic pointer and never block, while publishing a replacement
+ * swaps the pointer and retires the previous table. Readers are not tracked,
+ * so retired tables are freed only when the caller, knowing that no lookup
+ * still uses them, calls reclaim().
+ */
+
+#pragma once
+
+#include <enum_cast.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace enum_cast_detail {
+
+/**
+ * Src -> Dst table built from rows at run time
+ *
+ * The backend is chosen as for the compile-time tables: a dense table when the
+ * source values are packed closely enough, otherwise a minimal perfect hash,
+ * and a sorted array for very long columns or when no perfect hash is found.
+ * When a source value occurs in several rows the first row wins.
+ */
+template <EnumConcept Src, EnumConcept Dst>
+class runtime_table
+{
+public:
+    using underlying_type = std::underlying_type_t<Src>;
+    using offset_type = std::make_unsigned_t<underlying_type>;
+
+    runtime_table(std::span<const std::pair<Src, Dst>> rows, Dst fallback) : fallback_(fallback)
+    {
+        for (const auto& [src, dst] : rows) {
+            keys_.push_back({ static_cast<underlying_type>(src), dst });
+        }
+        // Stable, so the first row of each source value stays in front of its duplicates
+        std::stable_sort(keys_.begin(), keys_.end(), [](const slot& a, const slot& b) { return a.key < b.key; });
+        keys_.erase(std::unique(keys_.begin(), keys_.end(), [](const slot& a, const slot& b) { return a.key == b.key; }),
+                    keys_.end());
+        if (keys_.empty()) {
+            return;
+        }
+
+        min_ = keys_.front().key;
+        const std::uint64_t extent = offset_of(keys_.back().key);
+        if (extent < dense_table_small_size || extent / dense_table_max_slots_per_row < rows.size()) {
+            strategy_ = enum_lookup_strategy::dense_table;
+            values_.assign(extent + 1, fallback_);
+            filled_.assign(extent + 1, false);
+            for (const auto& entry : keys_) {
+                values_[offset_of(entry.key)] = entry.value;
+                filled_[offset_of(entry.key)] = true;
+            }
+        } else if (keys_.size() <= perfect_hash_max_rows) {
+            std::vector<std::uint64_t> hashes;
+            for (const auto& entry : keys_) {
+                hashes.push_back(hash_key(static_cast<std::uint64_t>(entry.key)));
+            }
+            std::vector<hash_displace_seed> seeds(hash_displace_buckets(keys_.size()));
+            std::vector<std::size_t> order(keys_.size());
+            if (hash_displace_place(hashes, seeds, order)) {
+                strategy_ = enum_lookup_strategy::perfect_hash;
+                seeds_ = std::move(seeds);
+                slots_.resize(keys_.size());
+                for (std::size_t i = 0; i < order.size(); ++i) {
+                    slots_[i] = keys_[order[i]];
+                }
+            }
+        }
+    }
+
+    enum_lookup_strategy strategy() const noexcept
+    {
+        return strategy_;
+    }
+
+    Dst lookup(Src src) const noexcept
+    {
+        return find(src).value_or(fallback_);
+    }
+
+    std::optional<Dst> find(Src src) const noexcept
+    {
+        const auto key = static_cast<underlying_type>(src);
+        switch (strategy_) {
+        case enum_lookup_strategy::dense_table: {
+            auto index = offset_of(key);
+            if (index < values_.size() && filled_[index]) {
+                return values_[index];
+            }
+            return std::nullopt;
+        }
+        case enum_lookup_strategy::perfect_hash: {
+            auto hash = hash_key(static_cast<std::uint64_t>(key));
+            auto seed = seeds_[hash_displace_bucket(hash, seeds_.size())];
+            const auto& entry = slots_[hash_displace_slot(hash, seed, slots_.size())];
+            if (entry.key == key) {
+                return entry.value;
+            }
+            return std::nullopt;
+        }
+        default: {
+            auto it = std::lower_bound(keys_.begin(), keys_.end(), key,
+                                       [](const slot& entry, underlying_type value) { return entry.key < value; });
+            if (it != keys_.end() && it->key == key) {
+                return it->value;
+            }
+            return std::nullopt;
+        }
+        }
+    }
+
+private:
+    struct slot
+    {
+        underlying_type key;
+        Dst value;
+    };
+
+    offset_type offset_of(underlying_type value) const noexcept
+    {
+        return static_cast<offset_type>(static_cast<offset_type>(value) - static_cast<offset_type>(min_));
+    }
+
+    Dst fallback_;
+    enum_lookup_strategy strategy_ = enum_lookup_strategy::sorted_array;
+    underlying_type min_ {};
+    // Distinct source values in ascending order, each with its first row's Dst value
+    std::vector<slot> keys_;
+    std::vector<Dst> values_;
+    std::vector<bool> filled_;
+    std::vector<hash_displace_seed> seeds_;
+    std::vector<slot> slots_;
+};
+
+} // namespace enum_cast_detail
+
+/**
+ * Src -> Dst mappings of a category, registered at run time
+ *
+ * @tparam Category The category tag; it needs no enum_mapping_traits specialization
+ * @tparam Src The source enum type
+ * @tparam Dst The destination enum type
+ *
+ * @note Lookups load the current table with one acquire load and take no lock.
+ *       publish() builds the new table before swapping it in, so readers see
+ *       either the old table or the new one, never a partial one.
+ * @note Replaced tables are retired, not freed, since a reader may still be
+ *       using one. Call reclaim() once every lookup that started before the
+ *       last publish() has finished, for example after a reload barrier.
+ */
+template <typename Category, EnumConcept Src, EnumConcept Dst>
+struct enum_cast_registry
+{
+    using row_type = std::pair<Src, Dst>;
+    using table_type = enum_cast_detail::runtime_table<Src, Dst>;
+
+    /**
+     * Builds a table from rows and makes it the current one, replacing any
+     * table published before
+     *
+     * @param rows The mappings; the first row of a repeated source value wins
+     * @param fallback Value returned by lookup() for unmapped sources
+     *
+     * @note Concurrent publishers are serialized; readers are never blocked
+     */
+    static void publish(std::span<const row_type> rows, Dst fallback = static_cast<Dst>(0))
+    {
+        auto table = std::make_unique<const table_type>(rows, fallback);
+        std::lock_guard lock(state_.writer);
+        state_.tables.push_back(std::move(table));
+        state_.current.store(state_.tables.back().get(), std::memory_order_release);
+    }
+
+    static void publish(std::initializer_list<row_type> rows, Dst fallback = static_cast<Dst>(0))
+    {
+        publish(std::span<const row_type>(rows.begin(), rows.size()), fallback);
+    }
+
+    // Whether a table has been published
+    static bool published() noexcept
+    {
+        return state_.current.load(std::memory_order_acquire) != nullptr;
+    }
+
+    /**
+     * Frees the tables replaced by later publish() calls
+     *
+     * @return The number of tables freed
+     *
+     * @note Readers are not counted, so reclaim() cannot wait for them; the
+     *       caller guarantees that no reader still holds a replaced table
+     */
+    static std::size_t reclaim()
+    {
+        std::lock_guard lock(state_.writer);
+        const table_type* current = state_.current.load(std::memory_order_relaxed);
+        auto retired = std::remove_if(state_.tables.begin(), state_.tables.end(),
+                                      [&](const auto& table) { return table.get() != current; });
+        auto count = static_cast<std::size_t>(state_.tables.end() - retired);
+        state_.tables.erase(retired, state_.tables.end());
+        return count;
+    }
+
+    // The mapped value, or the published fallback (static_cast<Dst>(0) before any publish())
+    static Dst lookup(Src src) noexcept
+    {
+        const table_type* table = state_.current.load(std::memory_order_acquire);
+        return table ? table->lookup(src) : static_cast<Dst>(0);
+    }
+
+    static std::optional<Dst> find(Src src) noexcept
+    {
+        const table_type* table = state_.current.load(std::memory_order_acquire);
+        return table ? table->find(src) : std::nullopt;
+    }
+
+    // Backend of the current table, or nullopt before any publish()
+    static std::optional<enum_lookup_strategy> strategy() noexcept
+    {
+        const table_type* table = state_.current.load(std::memory_order_acquire);
+        return table ? std::optional(table->strategy()) : std::nullopt;
+    }
+
+private:
+    struct registry_state
+    {
+        std::atomic<const table_type*> current { nullptr };
+        std::mutex writer;
+        // Every table not yet reclaimed, the current one included
+        std::vector<std::unique_ptr<const table_type>> tables;
+    };
+
+    // Constant-initialized, so lookups from other static initializers find it ready
+    constinit static inline registry_state state_ {};
+};
+
+/**
+ * Converts src through the table registered for Category
+ *
+ * @tparam Category The category tag the rows were published under
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src The value to convert
+ * @return The mapped value, or the fallback given to publish()
+ */
+template <typename Category, EnumConcept Dst, EnumConcept Src>
+Dst registered_enum_cast(Src src) noexcept
+{
+    return enum_cast_registry<Category, Src, Dst>::lookup(src);
+}
+
+/**
+ * Converts src through the table registered for Category
+ *
+ * @return The mapped value, or std::nullopt when src has no mapping or nothing
+ *         has been published yet
+ */
+template <typename Category, EnumConcept Dst, EnumConcept Src>
+std::optional<Dst> try_registered_enum_cast(Src src) noexcept
+{
+    return enum_cast_registry<Category, Src, Dst>::find(src);
+}
@@ -0,0 +1,171 @@
+/*
+ * enum_cast_stream.hpp - Translation of packed enum columns in files
+ *
+ * Record files often hold long arrays of one library's enum codes. The
+ * translators here read such a column as raw bytes, from a memory-mapped
+ * region or a std::istream, convert it with enum_cast_n and write the other
+ * library's codes, without a per-element allocation or a copy of the file.
+ *
+ * Key components:
+ * - enum_cast_column: Translates a byte range, such as a mapped file, into an
+ *   output byte range
+ * - enum_cast_stream: Translates a std::istream into a std::ostream chunk by chunk
+ *
+ * Values are the enums' underlying integers in native byte order, one after
+ * another and without alignment requirements. Large inputs are split into
+ * chunks translated on worker threads.
+ */
+
+#pragma once
+
+#include <enum_cast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace enum_cast_detail {
+
+// Values converted per staging block; both blocks stay in the L1 cache
+inline constexpr std::size_t column_block_values = 1024;
+// Smallest part of a column worth a thread of its own
+inline constexpr std::size_t column_min_chunk_values = std::size_t(1) << 18;
+
+/*
+ * Converts count packed Src values at src into packed Dst values at dst,
+ * staging them through aligned blocks so that the batch kernels run on
+ * properly typed arrays whatever the alignment of the buffers
+ */
+template <EnumConcept Dst, EnumConcept Src>
+void translate_column(const std::byte* src, std::byte* dst, std::size_t count)
+{
+    std::array<Src, column_block_values> in;
+    std::array<Dst, column_block_values> out;
+    for (std::size_t done = 0; done < count;) {
+        std::size_t block = std::min(count - done, column_block_values);
+        std::memcpy(in.data(), src + done * sizeof(Src), block * sizeof(Src));
+        enum_cast_n<Dst>(std::span<const Src>(in.data(), block), std::span<Dst>(out.data(), block));
+        std::memcpy(dst + done * sizeof(Dst), out.data(), block * sizeof(Dst));
+        done += block;
+    }
+}
+
+inline std::size_t column_threads(std::size_t requested)
+{
+    return requested != 0 ? requested : std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Runs translate_column over chunks of at most chunk values each, the first on the calling thread;
+// the other chunks get a fresh std::jthread each, joined before returning
+template <EnumConcept Dst, EnumConcept Src>
+void translate_chunks(const std::byte* src, std::byte* dst, std::size_t count, std::size_t chunk)
+{
+    std::vector<std::jthread> workers;
+    workers.reserve(count / chunk);
+    for (std::size_t start = chunk; start < count; start += chunk) {
+        workers.emplace_back(translate_column<Dst, Src>, src + start * sizeof(Src), dst + start * sizeof(Dst),
+                             std::min(chunk, count - start));
+    }
+    translate_column<Dst, Src>(src, dst, std::min(chunk, count));
+}
+
+} // namespace enum_cast_detail
+
+/**
+ * Translates a packed column of Src values into a packed column of Dst values
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param src Consecutive Src underlying values, for example a memory-mapped file
+ * @param dst Receives the Dst underlying values; must hold at least
+ *        src.size() / sizeof(Src) * sizeof(Dst) bytes
+ * @param threads Threads to spread a large column over; 0 uses
+ *        std::thread::hardware_concurrency()
+ * @return The number of values translated; trailing bytes that do not form a
+ *         whole value are left alone
+ *
+ * @note Each value converts exactly as enum_cast would; neither buffer needs
+ *       to be aligned
+ * @note Columns shorter than enum_cast_detail::column_min_chunk_values per
+ *       thread are translated on the calling thread
+ */
+template <EnumConcept Dst, EnumConcept Src>
+std::size_t enum_cast_column(std::span<const std::byte> src, std::span<std::byte> dst, std::size_t threads = 0)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    const std::size_t count = src.size() / sizeof(Src);
+    assert(dst.size() >= count * sizeof(Dst));
+    const std::size_t chunks = std::clamp<std::size_t>(count / enum_cast_detail::column_min_chunk_values, 1,
+                                                       enum_cast_detail::column_threads(threads));
+    const std::size_t chunk = std::max<std::size_t>(1, (count + chunks - 1) / chunks);
+    enum_cast_detail::translate_chunks<Dst, Src>(src.data(), dst.data(), count, chunk);
+    return count;
+}
+
+// Outcome of enum_cast_stream
+struct enum_cast_stream_result
+{
+    std::size_t values = 0;         // Values translated and written
+    std::size_t trailing_bytes = 0; // Bytes read after the last whole value, not written
+};
+
+/**
+ * Translates a stream of packed Src values into a stream of packed Dst values
+ *
+ * @tparam Dst The destination enum type
+ * @tparam Src The source enum type
+ * @param in Consecutive Src underlying values, read until end of stream
+ * @param out Receives the Dst underlying values in the same order
+ * @param chunk_values Values read per chunk; one chunk per thread is in flight
+ * @param threads Threads translating chunks side by side; 0 uses
+ *        std::thread::hardware_concurrency()
+ * @return The number of values written and the size of an incomplete value at
+ *         the end of the input
+ *
+ * @note The buffers are allocated once, threads * chunk_values values in each
+ *       direction; translation stops early when out fails, which its state shows
+ * @note Workers are not kept across refills: every refill of more than one
+ *       chunk starts and joins up to threads - 1 std::jthread, tens of
+ *       microseconds each, so chunk_values should keep a chunk's translation
+ *       well above that (the default of 2^18 values does)
+ */
+template <EnumConcept Dst, EnumConcept Src>
+enum_cast_stream_result enum_cast_stream(std::istream& in, std::ostream& out,
+                                         std::size_t chunk_values = enum_cast_detail::column_min_chunk_values,
+                                         std::size_t threads = 0)
+{
+    static_assert(std::is_same_v<enum_category_t<Src>, enum_category_t<Dst>>,
+                 "Source and destination enums must be of the same category");
+    assert(chunk_values > 0);
+    const std::size_t slots = enum_cast_detail::column_threads(threads);
+    std::vector<std::byte> input(slots * chunk_values * sizeof(Src));
+    std::vector<std::byte> output(slots * chunk_values * sizeof(Dst));
+    enum_cast_stream_result result;
+    bool more = true;
+    while (more && out) {
+        // Fills as many chunks as there are threads, so they translate as one column
+        std::size_t bytes = 0;
+        while (more && bytes < input.size()) {
+            in.read(reinterpret_cast<char*>(input.data() + bytes), static_cast<std::streamsize>(input.size() - bytes));
+            auto read = static_cast<std::size_t>(in.gcount());
+            bytes += read;
+            more = read != 0 && in.good();
+        }
+        const std::size_t count = bytes / sizeof(Src);
+        result.trailing_bytes = bytes % sizeof(Src);
+        enum_cast_detail::translate_chunks<Dst, Src>(input.data(), output.data(), count, chunk_values);
+        out.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(count * sizeof(Dst)));
+        if (out) {
+            result.values += count;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,83 @@
+/*
+ * enum_cast_core.cppm - The enum_cast core as the :core partition of module enum_cast
+ *
+ * Exports the public names of enum_cast.hpp, which is parsed once in the global
+ * module fragment. enum_cast_detail stays unexported; the exported templates
+ * still reach it when they are instantiated. The primary interface unit of the
+ * module is written per target by enum_cast_add_module, so that it can
+ * re-export the target's generated mapping partitions alongside this one.
+ */
+
+module;
+
+#include <enum_cast.hpp>
+
+export module enum_cast:core;
+
+export {
+    using ::EnumConcept;
+    using ::EnumFlagsConcept;
+    using ::EnumMappingTraitsConcept;
+
+    // Traits specialized by the categories
+    using ::enum_category;
+    using ::enum_category_t;
+    using ::enum_flags_enabled;
+    using ::enum_flags_enabled_v;
+    using ::enum_mapping_traits;
+    using ::enum_reflection_range;
+
+    using ::enum_cast_operation;
+    using ::enum_flag_kernel;
+    using ::enum_lookup_strategy;
+    using ::unmapped;
+    using ::unmapped_t;
+
+    using ::enum_mapping_bijective_v;
+    using ::enum_mapping_duplicate_keys_v;
+    using ::enum_mapping_footprint_v;
+    using ::enum_mapping_functional_v;
+    using ::enum_mapping_table_bytes_v;
+    using ::enum_round_trips;
+    using ::enum_round_trips_v;
+
+    using ::enum_mappings_by_name;
+    using ::enum_name_fold_case;
+
+    using ::enum_cast;
+    using ::enum_cast_all;
+    using ::enum_cast_n;
+    using ::enum_cast_via;
+#if defined(__cpp_lib_expected)
+    using ::expected_enum_cast;
+#endif
+    using ::try_enum_cast;
+    using ::try_enum_cast_via;
+
+    using ::enum_from_string;
+    using ::enum_from_string_n;
+    using ::enum_from_string_split;
+    using ::enum_parse_result;
+    using ::enum_to_string;
+
+    using ::enum_flag_bits_cast;
+    using ::enum_flag_bits_cast_checked;
+    using ::enum_flag_bits_cast_n;
+    using ::enum_flag_bits_cast_result;
+    using ::try_enum_flag_bits_cast;
+}
+
+export namespace views {
+    using ::views::enum_cast;
+}
+
+export namespace enum_flags {
+    using enum_flags::flags;
+    using enum_flags::operator|;
+    using enum_flags::operator&;
+    using enum_flags::operator^;
+    using enum_flags::operator~;
+    using enum_flags::operator|=;
+    using enum_flags::operator&=;
+    using enum_flags::operator^=;
+}
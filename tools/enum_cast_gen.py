@@ -0,0 +1,463 @@
+#!/usr/bin/env python3
+"""
+enum_cast_gen.py - Generates enum_cast mapping headers from enum descriptors
+
+Reads mapping tables from JSON or CSV files, and enum definitions from
+.proto files, and writes a header with the enum categories and
+enum_mapping_traits specializations already laid out for enum_cast:
+
+- rows are sorted by one column (the first unless --sort-by says otherwise),
+  so its keys need no sorting when the lookup tables are built; tables with
+  repeated values keep the input order, which first-match lookups depend on,
+  and precompute the order of that column too
+- every other column gets its row order precomputed (`sorted_rows`)
+- every column is emitted as a flat array of underlying values (`column`),
+  so nothing is unpacked from the tuple rows during compilation
+
+Inputs:
+
+  JSON  {"category": "vendor::StatusTag",
+         "includes": ["vendor_a/status.h"],
+         "enums": [{"type": "vendor_a::Status", "underlying": "std::int32_t",
+                    "enumerators": {"Ok": 0, "Busy": 7}},
+                   {"type": "vendor_b::Status"}],
+         "mappings": [["Ok", 1], ["Busy", "Waiting=4"]],
+         "default": ["Ok", 0],
+         "lookup_strategy": "sorted_array",
+         "allow_duplicate_keys": false}
+        A file may also hold {"categories": [...]} with several such objects.
+
+  CSV   A header row naming one enum type per column, optionally with its
+        underlying type ("vendor_a::Status:std::int32_t"), then one mapping
+        per row. Requires --category.
+
+  proto Enum definitions as generated by protoc (top-level enums as
+        package::Enum, nested ones as package::Outer_Enum). With --join the
+        listed enums are mapped onto each other by enumerator name, ignoring
+        the conventional ENUM_NAME_ prefix.
+
+A cell is an integer, an enumerator name known from the enum's descriptor, or
+"Name=value". Enums with an underlying type are defined by the generated
+header; the others must be declared by one of the included headers, with the
+values given in the descriptors.
+
+With --module-partition NAME the output is the C++20 module partition
+enum_cast:NAME instead of a header: the includes go into its global module
+fragment, and the enums it defines and the category tags are exported.
+
+Usage:
+  enum_cast_gen.py [--category TAG] [--join ENUM...] [--sort-by ENUM]
+                   [--include HEADER]... [--module-partition NAME]
+                   -o OUTPUT INPUT...
+"""
+
+import argparse
+import csv
+import json
+import os
+import re
+import sys
+
+
+class GeneratorError(Exception):
+    pass
+
+
+class EnumDesc:
+    def __init__(self, type_name, underlying=None, define=None, source=None):
+        self.type = type_name
+        self.underlying = underlying
+        self.define = underlying is not None if define is None else define
+        self.enumerators = {}
+        self.source = source
+
+    def add(self, name, value):
+        if name in self.enumerators and self.enumerators[name] != value:
+            raise GeneratorError(f"{self.type}::{name} is given as both {self.enumerators[name]} and {value}")
+        self.enumerators[name] = value
+
+
+class Category:
+    def __init__(self, tag, enums):
+        self.tag = tag
+        self.enums = enums
+        self.rows = []
+        self.default = None
+        self.lookup_strategy = None
+        self.allow_duplicate_keys = None
+
+
+def parse_int(text):
+    try:
+        return int(text, 0)
+    except (TypeError, ValueError):
+        return None
+
+
+def resolve_cell(enum, cell):
+    """Returns (enumerator name or None, value) for one cell of a mapping row."""
+    if isinstance(cell, bool):
+        raise GeneratorError(f"{enum.type}: {cell!r} is not an enum value")
+    if isinstance(cell, int):
+        return None, cell
+    text = str(cell).strip()
+    value = parse_int(text)
+    if value is not None:
+        return None, value
+    name, sep, literal = text.partition("=")
+    name = name.strip()
+    if sep:
+        value = parse_int(literal.strip())
+        if value is None:
+            raise GeneratorError(f"{enum.type}: {literal!r} is not an integer")
+        enum.add(name, value)
+        return name, value
+    if name not in enum.enumerators:
+        raise GeneratorError(f"{enum.type} has no value for enumerator {name!r}")
+    return name, enum.enumerators[name]
+
+
+# --- proto -------------------------------------------------------------------
+
+PROTO_TOKEN = re.compile(r'\s+|//[^\n]*|/\*.*?\*/|"(?:[^"\\]|\\.)*"|\'(?:[^\'\\]|\\.)*\'|[A-Za-z_][\w.]*|-?(?:0[xX][0-9a-fA-F]+|\d+)|.', re.S)
+
+
+def proto_tokens(text):
+    for match in PROTO_TOKEN.finditer(text):
+        token = match.group(0)
+        if not token.isspace() and not token.startswith("//") and not token.startswith("/*"):
+            yield token
+
+
+def skip_statement(tokens, i):
+    """Skips to just past the ';' or the matching '}' of the statement at i."""
+    depth = 0
+    while i < len(tokens):
+        if tokens[i] == "{":
+            depth += 1
+        elif tokens[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+        elif tokens[i] == ";" and depth == 0:
+            return i + 1
+        i += 1
+    return i
+
+
+def style_prefix(name):
+    """ENUM_NAME_ prefix the protobuf style guide puts on enumerators of ENUM_NAME."""
+    return re.sub(r"(?<=[a-z0-9])(?=[A-Z])|(?<=[A-Z])(?=[A-Z][a-z])", "_", name).upper() + "_"
+
+
+def parse_proto(path, registry):
+    with open(path, encoding="utf-8") as file:
+        tokens = list(proto_tokens(file.read()))
+    package = []
+
+    def parse_enum(scope, i):
+        name = tokens[i + 1]
+        cpp_name = "_".join(scope + [name])
+        namespace = "::".join(package)
+        enum = EnumDesc(f"{namespace}::{cpp_name}" if namespace else cpp_name, define=False, source=path)
+        enum.proto_name = ".".join(package + scope + [name])
+        enum.short_names = {}
+        value_prefix = cpp_name + "_" if scope else ""
+        i += 3
+        while tokens[i] != "}":
+            if tokens[i] in ("option", "reserved"):
+                i = skip_statement(tokens, i)
+                continue
+            if tokens[i + 1] != "=" or parse_int(tokens[i + 2]) is None:
+                raise GeneratorError(f"{path}: cannot parse enumerator {tokens[i]!r} of {enum.proto_name}")
+            enum.add(value_prefix + tokens[i], parse_int(tokens[i + 2]))
+            enum.short_names[tokens[i]] = value_prefix + tokens[i]
+            i = skip_statement(tokens, i + 2)
+        prefix = style_prefix(name)
+        if enum.short_names and all(short.startswith(prefix) and len(short) > len(prefix) for short in enum.short_names):
+            enum.join_names = {short[len(prefix):]: full for short, full in enum.short_names.items()}
+        else:
+            enum.join_names = dict(enum.short_names)
+        registry[enum.type] = enum
+        registry[enum.proto_name] = enum
+        return i + 1
+
+    def parse_block(scope, i):
+        while i < len(tokens) and tokens[i] != "}":
+            if tokens[i] == "package":
+                package[:] = tokens[i + 1].split(".")
+                i = skip_statement(tokens, i)
+            elif tokens[i] == "enum":
+                i = parse_enum(scope, i)
+            elif tokens[i] == "message":
+                i = parse_block(scope + [tokens[i + 1]], i + 3) + 1
+            else:
+                i = skip_statement(tokens, i)
+        return i
+
+    parse_block([], 0)
+
+
+def join_by_name(registry, names, tag):
+    enums = []
+    for name in names:
+        if name not in registry or not hasattr(registry[name], "join_names"):
+            raise GeneratorError(f"--join: no enum {name!r} in the .proto inputs")
+        enums.append(registry[name])
+    category = Category(tag, enums)
+    first = enums[0]
+    for short, full in first.join_names.items():
+        if all(short in enum.join_names for enum in enums[1:]):
+            category.rows.append([(enum.join_names[short], enum.enumerators[enum.join_names[short]]) for enum in enums])
+        else:
+            print(f"enum_cast_gen: {first.proto_name}.{full} has no counterpart in every joined enum, skipped", file=sys.stderr)
+    return category
+
+
+# --- JSON and CSV --------------------------------------------------------------
+
+def lookup_enum(registry, type_name, underlying=None):
+    if type_name in registry:
+        enum = registry[type_name]
+        if underlying is not None and enum.underlying not in (None, underlying):
+            raise GeneratorError(f"{type_name} is declared with underlying types {enum.underlying} and {underlying}")
+        return enum
+    enum = EnumDesc(type_name, underlying)
+    registry[type_name] = enum
+    return enum
+
+
+def parse_json_category(document, registry, path):
+    if "category" not in document or "enums" not in document:
+        raise GeneratorError(f"{path}: a category needs \"category\" and \"enums\"")
+    enums = []
+    for entry in document["enums"]:
+        enum = lookup_enum(registry, entry["type"], entry.get("underlying"))
+        for name, value in entry.get("enumerators", {}).items():
+            enum.add(name, parse_int(value) if isinstance(value, str) else value)
+        enums.append(enum)
+    category = Category(document["category"], enums)
+    for row in document.get("mappings", []):
+        if len(row) != len(enums):
+            raise GeneratorError(f"{path}: mapping {row} does not have {len(enums)} columns")
+        category.rows.append([resolve_cell(enum, cell) for enum, cell in zip(enums, row)])
+    if "default" in document:
+        category.default = [resolve_cell(enum, cell) for enum, cell in zip(enums, document["default"])]
+    category.lookup_strategy = document.get("lookup_strategy")
+    category.allow_duplicate_keys = document.get("allow_duplicate_keys")
+    return category
+
+
+def parse_json(path, registry):
+    with open(path, encoding="utf-8") as file:
+        document = json.load(file)
+    documents = document["categories"] if "categories" in document else [document]
+    return [parse_json_category(entry, registry, path) for entry in documents], document.get("includes", [])
+
+
+def parse_csv(path, registry, tag):
+    if tag is None:
+        raise GeneratorError(f"{path}: CSV input needs --category")
+    with open(path, newline="", encoding="utf-8") as file:
+        lines = [row for row in csv.reader(file) if row and not row[0].lstrip().startswith("#")]
+    if not lines:
+        raise GeneratorError(f"{path}: missing header row")
+    enums = []
+    for column in lines[0]:
+        # A single ':' separates the underlying type; "::" belongs to the names
+        type_name, underlying = (re.split(r"(?<!:):(?!:)", column.strip(), maxsplit=1) + [""])[:2]
+        enums.append(lookup_enum(registry, type_name.strip(), underlying.strip() or None))
+    category = Category(tag, enums)
+    for number, row in enumerate(lines[1:], start=2):
+        if len(row) != len(enums):
+            raise GeneratorError(f"{path}:{number}: expected {len(enums)} columns, got {len(row)}")
+        category.rows.append([resolve_cell(enum, cell) for enum, cell in zip(enums, row)])
+    return category
+
+
+# --- output --------------------------------------------------------------------
+
+def value_literal(value):
+    if value == -(1 << 63):
+        return "(-9223372036854775807 - 1)"
+    if value >= 1 << 63:
+        return f"{value}ull"
+    return str(value)
+
+
+def enum_value(enum, cell):
+    name, value = cell
+    if name is not None:
+        return f"{enum.type}::{name}"
+    return f"static_cast<{enum.type}>({value_literal(value)})"
+
+
+def split_name(qualified):
+    *namespace, name = qualified.split("::")
+    return "::".join(namespace), name
+
+
+def in_namespace(qualified, body, exported=False):
+    namespace, _ = split_name(qualified)
+    export = "export " if exported else ""
+    if not namespace:
+        return export + body
+    return f"{export}namespace {namespace} {{\n{body}}} // namespace {namespace}\n"
+
+
+def emit_enum(enum, exported=False):
+    _, name = split_name(enum.type)
+    values = "".join(f"    {key} = {value_literal(value)},\n" for key, value in sorted(enum.enumerators.items(), key=lambda item: item[1]))
+    return in_namespace(enum.type, f"enum class {name} : {enum.underlying}\n{{\n{values}}};\n", exported)
+
+
+def index_type(rows):
+    return "std::uint16_t" if rows <= 0xffff else "std::uint32_t"
+
+
+def sorts_by(enum, sort_by):
+    return sort_by in (enum.type, getattr(enum, "proto_name", None))
+
+
+def emit_category(category, sort_by, exported=False):
+    enums = category.enums
+    if len({enum.type for enum in enums}) != len(enums):
+        raise GeneratorError(f"{category.tag}: an enum appears in more than one column")
+    key = 0
+    if sort_by is not None:
+        matches = [i for i, enum in enumerate(enums) if sorts_by(enum, sort_by)]
+        key = matches[0] if matches else 0
+    # Lookups resolve a repeated value by its first row, so such tables keep the input order
+    keep_order = bool(category.allow_duplicate_keys) or any(
+        len({row[column][1] for row in category.rows}) != len(category.rows)
+        for column in range(len(enums)) if column != key)
+    rows = list(category.rows) if keep_order else sorted(category.rows, key=lambda row: row[key][1])
+    count = len(rows)
+
+    out = []
+    _, tag_name = split_name(category.tag)
+    out.append(in_namespace(category.tag, f"struct {tag_name} {{}};\n", exported))
+    if split_name(category.tag)[0]:
+        out.append("\n")
+    for enum in enums:
+        out.append(f"template <> struct enum_category<{enum.type}> {{ using type = {category.tag}; }};\n")
+    out.append("\n")
+
+    types = ", ".join(enum.type for enum in enums)
+    out.append("template <>\n")
+    out.append(f"struct enum_mapping_traits<{category.tag}>\n{{\n")
+    out.append(f"    using mapping_type = std::tuple<{types}>;\n")
+    if category.lookup_strategy is not None:
+        out.append(f"    constexpr static enum_lookup_strategy lookup_strategy = enum_lookup_strategy::{category.lookup_strategy};\n")
+    if category.allow_duplicate_keys is not None:
+        out.append(f"    constexpr static bool allow_duplicate_keys = {'true' if category.allow_duplicate_keys else 'false'};\n")
+    if category.default is not None:
+        cells = ", ".join(enum_value(enum, cell) for enum, cell in zip(enums, category.default))
+        out.append(f"    constexpr static mapping_type default_mapping = {{ {cells} }};\n")
+    if count == 0:
+        out.append("    constexpr static std::array<mapping_type, 0> mappings {};\n};\n")
+        return "".join(out)
+
+    if keep_order:
+        out.append("    // In input order, as repeated values resolve to their first row\n")
+    else:
+        out.append(f"    // Ordered by {enums[key].type}\n")
+    out.append("    constexpr static mapping_type mappings[] = {\n")
+    for row in rows:
+        cells = ", ".join(enum_value(enum, cell) for enum, cell in zip(enums, row))
+        out.append(f"        {{ {cells} }},\n")
+    out.append("    };\n")
+
+    for column, enum in enumerate(enums):
+        values = ", ".join(value_literal(row[column][1]) for row in rows)
+        out.append(f"\n    constexpr static std::array<std::underlying_type_t<{enum.type}>, {count}> column(std::type_identity<{enum.type}>)\n")
+        out.append(f"    {{\n        return {{ {values} }};\n    }}\n")
+    for column, enum in enumerate(enums):
+        if column == key and not keep_order:
+            continue
+        order = sorted(range(count), key=lambda row: (rows[row][column][1], row))
+        out.append(f"\n    constexpr static std::array<{index_type(count)}, {count}> sorted_rows(std::type_identity<{enum.type}>)\n")
+        out.append(f"    {{\n        return {{ {', '.join(map(str, order))} }};\n    }}\n")
+    out.append("};\n")
+    return "".join(out)
+
+
+def include_spelling(header):
+    return header if header.startswith(("<", '"')) else f'"{header}"'
+
+
+def generate(categories, includes, sources, sort_by, partition=None):
+    """A header, or with partition the module partition enum_cast:<partition> exporting the defined enums and tags"""
+    exported = partition is not None
+    # Categories without the enum keep their first column, but the name must order at least one
+    if sort_by is not None and not any(sorts_by(enum, sort_by) for category in categories for enum in category.enums):
+        raise GeneratorError(f"--sort-by {sort_by}: no category has such an enum")
+    out = [f"// Generated by enum_cast_gen.py from {', '.join(sources)} - do not edit\n",
+           "module;\n\n" if exported else "#pragma once\n\n",
+           "#include <enum_cast.hpp>\n\n",
+           "#include <array>\n#include <cstdint>\n#include <tuple>\n#include <type_traits>\n"]
+    if includes:
+        out.append("\n" + "".join(f"#include {include_spelling(include)}\n" for include in includes))
+    if exported:
+        out.append(f"\nexport module enum_cast:{partition};\n\nimport :core;\n")
+    defined = []
+    for category in categories:
+        for enum in category.enums:
+            if enum.define and enum not in defined:
+                defined.append(enum)
+    for enum in defined:
+        out.append("\n" + emit_enum(enum, exported))
+    for category in categories:
+        out.append("\n" + emit_category(category, sort_by, exported))
+    return "".join(out)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="Generate enum_cast mapping headers from JSON, CSV or .proto enum descriptors.")
+    parser.add_argument("inputs", nargs="+", metavar="INPUT", help=".json, .csv or .proto descriptor files")
+    parser.add_argument("-o", "--output", required=True, help="header or module partition to write")
+    parser.add_argument("--category", help="category tag for CSV input and --join, e.g. vendor::StatusTag")
+    parser.add_argument("--join", nargs="+", metavar="ENUM", help="map these .proto enums onto each other by enumerator name")
+    parser.add_argument("--sort-by", metavar="ENUM", help="enum whose column orders the rows (default: the first)")
+    parser.add_argument("--include", action="append", default=[], metavar="HEADER", help="header declaring enums the output does not define")
+    parser.add_argument("--module-partition", metavar="NAME", help="write the module partition enum_cast:NAME instead of a header")
+    args = parser.parse_args(argv)
+
+    try:
+        registry = {}
+        categories = []
+        includes = list(args.include)
+        for path in sorted(args.inputs, key=lambda path: not path.endswith(".proto")):
+            extension = os.path.splitext(path)[1].lower()
+            if extension == ".proto":
+                parse_proto(path, registry)
+            elif extension == ".json":
+                parsed, extra = parse_json(path, registry)
+                categories += parsed
+                includes += extra
+            elif extension == ".csv":
+                categories.append(parse_csv(path, registry, args.category))
+            else:
+                raise GeneratorError(f"{path}: unknown input type {extension!r}")
+        if args.join:
+            if args.category is None:
+                raise GeneratorError("--join needs --category")
+            categories.append(join_by_name(registry, args.join, args.category))
+        if not categories:
+            raise GeneratorError("no mappings in the inputs (.proto files only provide enums; use --join)")
+        if args.module_partition is not None and not re.fullmatch(r"[A-Za-z_]\w*(\.[A-Za-z_]\w*)*", args.module_partition):
+            raise GeneratorError(f"{args.module_partition!r} is not a module partition name")
+        text = generate(categories, includes, [os.path.basename(path) for path in args.inputs], args.sort_by,
+                        args.module_partition)
+    except (GeneratorError, OSError, KeyError, json.JSONDecodeError) as error:
+        print(f"enum_cast_gen: error: {error}", file=sys.stderr)
+        return 1
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w", encoding="utf-8") as file:
+        file.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())